@@ -0,0 +1,79 @@
+// Headless timing of the primitive generators (no GL context needed).
+// usage: primitives_bench [iterations]
+#include "primitives.h"
+#include "ring.h"
+#include "mesh_optimizer.h"
+#include "worker_pool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+static void Run(const char* name, int iterations, const std::function<MeshData()>& generate) {
+    size_t vertexCount = 0, triangleCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        auto mesh = generate();
+        vertexCount = mesh.GetVertexCount();
+        triangleCount = mesh.GetTriangleCount();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+    printf("%-28s %10zu vertices %10zu triangles %10.3f ms\n",
+        name, vertexCount, triangleCount, ms);
+}
+
+int main(int argc, const char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 10;
+    if (iterations <= 0)
+        iterations = 1;
+    printf("ring simd path: %s, worker threads: %d\n",
+        GetRingSimdPath(), WorkerPool::Shared().GetThreadCount());
+
+    TessellationOptions serial;
+    serial.parallel = false;
+
+    Run("box", iterations, [] { return GenerateBox(); });
+    Run("cylinder 32", iterations, [] { return GenerateCylinder(0.5f, 0.5f, 32, 1.0f); });
+    Run("cylinder 4096", iterations, [] { return GenerateCylinder(0.5f, 0.3f, 4096, 1.0f); });
+    Run("sphere 32x16", iterations, [] { return GenerateSphere(0.5f, 32, 16); });
+    Run("sphere 100x100", iterations, [] { return GenerateSphere(0.5f, 100, 100); });
+    Run("sphere 1000x500", iterations, [] { return GenerateSphere(0.5f, 1000, 500); });
+    Run("sphere 1000x500 serial", iterations, [&] { return GenerateSphere(0.5f, 1000, 500, serial); });
+    Run("torus 32x16", iterations, [] { return GenerateTorus(0.3f, 0.15f, 32, 16); });
+    Run("torus 1000x500", iterations, [] { return GenerateTorus(0.3f, 0.15f, 1000, 500); });
+    Run("cylinder 1000000", iterations, [] { return GenerateCylinder(0.5f, 0.3f, 1000000, 1.0f); });
+    Run("cylinder 1000000 serial", iterations, [&] { return GenerateCylinder(0.5f, 0.3f, 1000000, 1.0f, serial); });
+
+    for (auto& item : { std::make_pair("sphere 100x100", GenerateSphere(0.5f, 100, 100)),
+            std::make_pair("torus 300x100", GenerateTorus(0.3f, 0.15f, 300, 100)) }) {
+        auto mesh = item.second;
+        auto start = std::chrono::steady_clock::now();
+        auto report = OptimizeMesh(mesh);
+        auto end = std::chrono::steady_clock::now();
+        printf("optimize %-19s ACMR %.3f -> %.3f  ATVR %.3f -> %.3f %10.3f ms\n", item.first,
+            report.before.acmr, report.after.acmr, report.before.atvr, report.after.atvr,
+            std::chrono::duration<double, std::milli>(end - start).count());
+    }
+
+    // list (cache optimized) vs strip: index count and simulated vertex cache
+    TessellationOptions strips;
+    strips.topology = PrimitiveTopology::TriangleStrip;
+    struct { const char* name; MeshData list; MeshData strip; } pairs[] = {
+        { "cylinder 128", GenerateCylinder(0.5f, 0.5f, 128, 1.0f),
+            GenerateCylinder(0.5f, 0.5f, 128, 1.0f, strips) },
+        { "sphere 100x100", GenerateSphere(0.5f, 100, 100),
+            GenerateSphere(0.5f, 100, 100, strips) },
+        { "torus 300x100", GenerateTorus(0.3f, 0.15f, 300, 100),
+            GenerateTorus(0.3f, 0.15f, 300, 100, strips) },
+    };
+    for (auto& pair : pairs) {
+        auto list = OptimizeMesh(pair.list).after;
+        auto strip = AnalyzeVertexCache(pair.strip);
+        printf("%-16s list %8zu idx ACMR %.3f | strip %8zu idx ACMR %.3f | %.2fx fewer indices\n",
+            pair.name, pair.list.indices.size(), list.acmr,
+            pair.strip.indices.size(), strip.acmr,
+            (double)pair.list.indices.size() / pair.strip.indices.size());
+    }
+    return 0;
+}
@@ -0,0 +1,18 @@
+// 프레임마다 한 번 쓰고 모든 program이 공유 (UniformBuffer "FrameData")
+// 멤버를 바꾸면 Context의 FrameDataLayout도 같이 바꿔야 함
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 viewport;  // x, y, width, height
+    float time;     // seconds
+    float srgbOutput;  // 1 if the framebuffer encodes to sRGB (GL_FRAMEBUFFER_SRGB)
+};
+
+// 텍스처가 아닌 색(sRGB 값 그대로 출력하던 색)을 출력 인코딩에 맞춤.
+// sRGB framebuffer는 출력을 다시 인코딩하므로 미리 linear로 풀어 둠
+vec3 OutputColor(vec3 color) {
+    if (srgbOutput == 0.0)
+        return color;
+    return mix(color / 12.92, pow((color + 0.055) / 1.055, vec3(2.4)), step(0.04045, color));
+}
@@ -0,0 +1,11 @@
+#version 330 core
+in vec3 normal;
+in vec2 texCoord;
+in vec4 instanceColor;
+out vec4 fragColor;
+
+uniform sampler2D tex;
+
+void main() {
+    fragColor = texture(tex, texCoord) * instanceColor;
+}
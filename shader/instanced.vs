@@ -0,0 +1,23 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoord;
+// instance마다 하나씩 (glVertexAttribDivisor 1)
+layout (location = 3) in mat4 aInstanceModel;
+layout (location = 7) in vec4 aInstanceColor;
+
+#include "frame_data.glsl"
+// 모든 instance에 공통인 scale / 회전 / dequantize
+uniform mat4 model;
+
+out vec3 normal;
+out vec2 texCoord;
+out vec4 instanceColor;
+
+void main() {
+    gl_Position = viewProjection * aInstanceModel * model * vec4(aPos, 1.0);
+    normal = aNormal;
+    texCoord = aTexCoord;
+    // 텍스처(linear로 샘플링)와 곱하므로 같은 공간으로
+    instanceColor = vec4(OutputColor(aInstanceColor.rgb), aInstanceColor.a);
+}
@@ -0,0 +1,106 @@
+#version 330 core
+// vertex attribute 없이 gl_VertexID와 uniform만으로 정점을 계산
+// 삼각형 리스트 순서와 정점 값은 primitives.cpp의 생성기와 같음
+
+// 1: cylinder, 2: sphere, 3: torus (PrimitiveType)
+uniform int primitiveType;
+// cylinder: (segment, -), sphere: (sector, stack), torus: (ring, tube)
+uniform ivec2 segments;
+// cylinder: (upper, lower, height), sphere: (radius, -, -), torus: (ring, tube, -)
+uniform vec3 params;
+
+#include "frame_data.glsl"
+// 물체마다 바뀌는 값만 개별 uniform
+uniform mat4 model;
+#ifdef ATLAS
+// atlas 안에서 이 물체의 영역 (AtlasRegion::uvTransform)
+uniform vec4 atlasRegion;
+#endif
+
+out vec3 normal;
+out vec2 texCoord;
+
+const float pi = 3.14159265;
+
+// 격자 한 칸(quad)을 이루는 두 삼각형의 (열, 행) 오프셋
+const ivec2 kQuadCorners[6] = ivec2[6](
+    ivec2(0, 0), ivec2(0, 1), ivec2(1, 0),
+    ivec2(1, 0), ivec2(0, 1), ivec2(1, 1));
+// torus는 반대 대각선
+const ivec2 kTorusCorners[6] = ivec2[6](
+    ivec2(0, 0), ivec2(1, 0), ivec2(0, 1),
+    ivec2(1, 0), ivec2(1, 1), ivec2(0, 1));
+
+vec3 position;
+
+void Cylinder(int vertex) {
+    int segment = segments.x;
+    float halfHeight = params.z * 0.5;
+    int sideCount = segment * 6;
+    if (vertex < sideCount) {
+        ivec2 cell = kQuadCorners[vertex % 6] + ivec2(vertex / 6, 0);
+        float angle = 2.0 * pi * float(cell.x % segment) / float(segment);
+        float radius = cell.y == 0 ? params.y : params.x;
+        float slope = params.y - params.x;
+        position = vec3(cos(angle) * radius, cell.y == 0 ? -halfHeight : halfHeight, sin(angle) * radius);
+        normal = normalize(vec3(params.z * cos(angle), slope, params.z * sin(angle)));
+        texCoord = vec2(float(cell.x) / float(segment), float(cell.y));
+        return;
+    }
+
+    // 뚜껑: 중심, i, i + 1 (위 뚜껑은 뒤의 두 정점을 바꿔 감는 방향을 뒤집음)
+    vertex -= sideCount;
+    bool top = vertex >= segment * 3;
+    int triangle = (vertex / 3) % segment;
+    int corner = vertex % 3;
+    float ny = top ? 1.0 : -1.0;
+    normal = vec3(0.0, ny, 0.0);
+    if (corner == 0) {
+        position = vec3(0.0, ny * halfHeight, 0.0);
+        texCoord = vec2(0.5);
+        return;
+    }
+    int i = triangle + ((corner == 2) != top ? 1 : 0);
+    float angle = 2.0 * pi * float(i % segment) / float(segment);
+    float radius = top ? params.x : params.y;
+    position = vec3(cos(angle) * radius, ny * halfHeight, sin(angle) * radius);
+    texCoord = vec2(0.5 + 0.5 * cos(angle), 0.5 - 0.5 * ny * sin(angle));
+}
+
+void Sphere(int vertex) {
+    int sector = segments.x;
+    int stack = segments.y;
+    int quad = vertex / 6;
+    ivec2 cell = kQuadCorners[vertex % 6] + ivec2(quad % sector, quad / sector);
+    float theta = 2.0 * pi * float(cell.x % sector) / float(sector);
+    float phi = pi / 2.0 - pi * float(cell.y) / float(stack);
+    normal = vec3(cos(phi) * cos(theta), cos(phi) * sin(theta), sin(phi));
+    position = params.x * normal;
+    texCoord = vec2(float(cell.x) / float(sector), 1.0 - float(cell.y) / float(stack));
+}
+
+void Torus(int vertex) {
+    int ringSegment = segments.x;
+    int tubeSegment = segments.y;
+    int quad = vertex / 6;
+    ivec2 cell = kTorusCorners[vertex % 6] + ivec2(quad % ringSegment, quad / ringSegment);
+    float theta = 2.0 * pi * float(cell.x % ringSegment) / float(ringSegment);
+    float psi = 2.0 * pi * float(cell.y % tubeSegment) / float(tubeSegment);
+    normal = vec3(cos(psi) * cos(theta), cos(psi) * sin(theta), sin(psi));
+    float radius = params.x + params.y * cos(psi);
+    position = vec3(radius * cos(theta), radius * sin(theta), params.y * sin(psi));
+    texCoord = vec2(float(cell.x) / float(ringSegment), float(cell.y) / float(tubeSegment));
+}
+
+void main() {
+    if (primitiveType == 1)
+        Cylinder(gl_VertexID);
+    else if (primitiveType == 2)
+        Sphere(gl_VertexID);
+    else
+        Torus(gl_VertexID);
+    gl_Position = viewProjection * model * vec4(position, 1.0);
+#ifdef ATLAS
+    texCoord = texCoord * atlasRegion.xy + atlasRegion.zw;
+#endif
+}
@@ -1,12 +1,24 @@
 #version 330 core
-in vec4 vertexColor;
+in vec3 normal;
 in vec2 texCoord;
 out vec4 fragColor;
 
+#include "frame_data.glsl"
+
+// feature define은 ShaderFeature 참고 (program variant마다 다르게 컴파일)
 uniform sampler2D tex;
+#ifdef DETAIL_TEXTURE
 uniform sampler2D tex2;
+uniform float detailBlend;
+#endif
 
 void main() {
-    fragColor = texture(tex, texCoord) * 1 +
-        texture(tex2, texCoord) * 0;
-}
\ No newline at end of file
+#ifdef NORMAL_VIEW
+    fragColor = vec4(OutputColor(normalize(normal) * 0.5 + 0.5), 1.0);
+#else
+    fragColor = texture(tex, texCoord);
+#ifdef DETAIL_TEXTURE
+    fragColor = mix(fragColor, texture(tex2, texCoord), detailBlend);
+#endif
+#endif
+}
@@ -1,15 +1,25 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
+layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
 
-uniform mat4 transform;
+#include "frame_data.glsl"
+// 물체마다 바뀌는 값만 개별 uniform
+uniform mat4 model;
+#ifdef ATLAS
+// atlas 안에서 이 물체의 영역 (AtlasRegion::uvTransform)
+uniform vec4 atlasRegion;
+#endif
 
-out vec4 vertexColor;
+out vec3 normal;
 out vec2 texCoord;
 
 void main() {
-    gl_Position = transform * vec4(aPos, 1.0);
-    vertexColor = vec4(aColor, 1.0);
+    gl_Position = viewProjection * model * vec4(aPos, 1.0);
+    normal = aNormal;
+#ifdef ATLAS
+    texCoord = aTexCoord * atlasRegion.xy + atlasRegion.zw;
+#else
     texCoord = aTexCoord;
+#endif
 }
\ No newline at end of file
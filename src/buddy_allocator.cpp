@@ -0,0 +1,100 @@
+#include "buddy_allocator.h"
+
+static size_t RoundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+
+BuddyAllocator::BuddyAllocator(size_t capacity, size_t minBlockSize) {
+    m_minBlockSize = RoundUpPowerOfTwo(minBlockSize > 0 ? minBlockSize : 1);
+    m_capacity = RoundUpPowerOfTwo(capacity > m_minBlockSize ? capacity : m_minBlockSize);
+    while (GetOrderSize(m_maxOrder) < m_capacity)
+        m_maxOrder++;
+    m_freeLists.resize(m_maxOrder + 1);
+    m_freeLists[m_maxOrder].insert(0);
+}
+
+int BuddyAllocator::GetOrder(size_t size) const {
+    int order = 0;
+    while (order <= m_maxOrder && GetOrderSize(order) < size)
+        order++;
+    return order;
+}
+
+size_t BuddyAllocator::Allocate(size_t size, size_t alignment) {
+    if (size == 0)
+        size = 1;
+    // a block is aligned to its own size, so a larger alignment just
+    // means a larger block
+    int order = GetOrder(size > alignment ? size : alignment);
+    if (order > m_maxOrder)
+        return kInvalidOffset;
+
+    int found = order;
+    while (found <= m_maxOrder && m_freeLists[found].empty())
+        found++;
+    if (found > m_maxOrder)
+        return kInvalidOffset;
+
+    size_t offset = *m_freeLists[found].begin();
+    m_freeLists[found].erase(m_freeLists[found].begin());
+    // split down to the requested order, keeping the lower half
+    while (found > order) {
+        found--;
+        m_freeLists[found].insert(offset + GetOrderSize(found));
+    }
+
+    m_allocations[offset] = Allocation { order, size };
+    m_usedBytes += GetOrderSize(order);
+    m_requestedBytes += size;
+    return offset;
+}
+
+void BuddyAllocator::Free(size_t offset) {
+    auto found = m_allocations.find(offset);
+    if (found == m_allocations.end())
+        return;
+    int order = found->second.order;
+    m_usedBytes -= GetOrderSize(order);
+    m_requestedBytes -= found->second.requested;
+    m_allocations.erase(found);
+
+    // merge with the buddy while it is free
+    while (order < m_maxOrder) {
+        size_t buddy = offset ^ GetOrderSize(order);
+        auto iter = m_freeLists[order].find(buddy);
+        if (iter == m_freeLists[order].end())
+            break;
+        m_freeLists[order].erase(iter);
+        offset = offset < buddy ? offset : buddy;
+        order++;
+    }
+    m_freeLists[order].insert(offset);
+}
+
+size_t BuddyAllocator::GetBlockSize(size_t offset) const {
+    auto found = m_allocations.find(offset);
+    return found == m_allocations.end() ? 0 : GetOrderSize(found->second.order);
+}
+
+BuddyAllocator::Stats BuddyAllocator::GetStats() const {
+    Stats stats;
+    stats.capacity = m_capacity;
+    stats.usedBytes = m_usedBytes;
+    stats.requestedBytes = m_requestedBytes;
+    stats.freeBytes = m_capacity - m_usedBytes;
+    stats.allocationCount = (uint32_t)m_allocations.size();
+    for (int order = 0; order <= m_maxOrder; order++) {
+        if (m_freeLists[order].empty())
+            continue;
+        stats.freeBlockCount += (uint32_t)m_freeLists[order].size();
+        stats.largestFreeBlock = GetOrderSize(order);
+    }
+    if (stats.freeBytes > 0)
+        stats.fragmentation = 1.0f - (float)stats.largestFreeBlock / stats.freeBytes;
+    if (stats.usedBytes > 0)
+        stats.internalWaste = (float)(stats.usedBytes - stats.requestedBytes) / stats.usedBytes;
+    return stats;
+}
@@ -0,0 +1,63 @@
+#ifndef __BUDDY_ALLOCATOR_H__
+#define __BUDDY_ALLOCATOR_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+// Binary buddy allocator over an abstract [0, capacity) range. It only
+// hands out offsets, so the same code manages GL buffers (BufferHeap) and
+// can be tested headless. Blocks are powers of two aligned to their own
+// size; freeing merges a block with its buddy as long as both are free.
+class BuddyAllocator {
+public:
+    static const size_t kInvalidOffset = (size_t)-1;
+
+    struct Stats {
+        size_t capacity { 0 };
+        size_t usedBytes { 0 };       // sum of block sizes handed out
+        size_t requestedBytes { 0 };  // sum of requested sizes
+        size_t freeBytes { 0 };
+        size_t largestFreeBlock { 0 };
+        uint32_t allocationCount { 0 };
+        uint32_t freeBlockCount { 0 };
+        // 1 - largest free block / free bytes: 0 when all free space is one block
+        float fragmentation { 0.0f };
+        // (used - requested) / used: space lost to power-of-two rounding
+        float internalWaste { 0.0f };
+    };
+
+    // capacity and minBlockSize are rounded up to powers of two
+    BuddyAllocator(size_t capacity, size_t minBlockSize = 256);
+
+    // kInvalidOffset when no block is large enough. alignment must be a
+    // power of two; blocks are aligned to max(block size, alignment)
+    size_t Allocate(size_t size, size_t alignment = 1);
+    void Free(size_t offset);
+
+    size_t GetCapacity() const { return m_capacity; }
+    // block size actually reserved for an allocation (0 if not allocated)
+    size_t GetBlockSize(size_t offset) const;
+    Stats GetStats() const;
+
+private:
+    int GetOrder(size_t size) const;
+    size_t GetOrderSize(int order) const { return m_minBlockSize << order; }
+
+    size_t m_capacity { 0 };
+    size_t m_minBlockSize { 0 };
+    int m_maxOrder { 0 };
+    // free block offsets per order, ordered so the lowest offset is reused first
+    std::vector<std::set<size_t>> m_freeLists;
+    struct Allocation {
+        int order;
+        size_t requested;
+    };
+    std::unordered_map<size_t, Allocation> m_allocations;
+    size_t m_usedBytes { 0 };
+    size_t m_requestedBytes { 0 };
+};
+
+#endif // __BUDDY_ALLOCATOR_H__
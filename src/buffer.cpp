@@ -9,6 +9,16 @@ BufferUPtr Buffer::CreateWithData(uint32_t bufferType, uint32_t usage,
     return std::move(buffer);
 }
 
+BufferUPtr Buffer::CreateWithStorage(uint32_t bufferType, uint32_t flags,
+    const void* data, size_t dataSize) {
+    if (!GLAD_GL_VERSION_4_4 && !GLAD_GL_ARB_buffer_storage)
+        return nullptr;
+    auto buffer = BufferUPtr(new Buffer());
+    if (!buffer->InitStorage(bufferType, flags, data, dataSize))
+        return nullptr;
+    return std::move(buffer);
+}
+
 Buffer::~Buffer() {
     if (m_buffer) {
         glDeleteBuffers(1, &m_buffer);
@@ -19,13 +29,45 @@ void Buffer::Bind() const {
     glBindBuffer(m_bufferType, m_buffer);
 }
 
+void Buffer::UpdateData(const void* data, size_t dataSize, size_t offset) const {
+    Bind();
+    glBufferSubData(m_bufferType, offset, dataSize, data);
+}
+
+void* Buffer::Map(size_t offset, size_t size, uint32_t access) const {
+    Bind();
+    return glMapBufferRange(m_bufferType, offset, size, access);
+}
+
+bool Buffer::Unmap() const {
+    Bind();
+    return glUnmapBuffer(m_bufferType) == GL_TRUE;
+}
+
+void Buffer::Orphan() const {
+    Bind();
+    glBufferData(m_bufferType, m_size, nullptr, m_usage);
+}
+
 bool Buffer::Init(uint32_t bufferType, uint32_t usage,
     const void* data, size_t dataSize) {
         
     m_bufferType = bufferType;
     m_usage = usage;
+    m_size = dataSize;
     glGenBuffers(1, &m_buffer);
     Bind();
     glBufferData(m_bufferType, dataSize, data, usage);
     return true;
+}
+
+bool Buffer::InitStorage(uint32_t bufferType, uint32_t flags,
+    const void* data, size_t dataSize) {
+    m_bufferType = bufferType;
+    m_size = dataSize;
+    m_immutable = true;
+    glGenBuffers(1, &m_buffer);
+    Bind();
+    glBufferStorage(m_bufferType, dataSize, data, flags);
+    return true;
 }
\ No newline at end of file
@@ -8,19 +8,36 @@ class Buffer {
 public:
     static BufferUPtr CreateWithData(uint32_t bufferType, uint32_t usage,
         const void* data, size_t dataSize);
+    // immutable storage (glBufferStorage, GL 4.4 / ARB_buffer_storage).
+    // flags: GL_MAP_PERSISTENT_BIT etc. nullptr if unsupported
+    static BufferUPtr CreateWithStorage(uint32_t bufferType, uint32_t flags,
+        const void* data, size_t dataSize);
 
     ~Buffer();
     uint32_t Get() const { return m_buffer; }
+    size_t GetSize() const { return m_size; }
     void Bind() const;
 
+    // in-place updates: the GL buffer object and its storage are kept
+    void UpdateData(const void* data, size_t dataSize, size_t offset = 0) const;
+    void* Map(size_t offset, size_t size, uint32_t access) const;
+    bool Unmap() const;
+    // new storage of the same size; draws still reading the old one keep it
+    void Orphan() const;
+    bool IsImmutable() const { return m_immutable; }
+
 private:
     Buffer() {}
     bool Init(
         uint32_t bufferType, uint32_t usage,
         const void* data, size_t dataSize);
+    bool InitStorage(uint32_t bufferType, uint32_t flags,
+        const void* data, size_t dataSize);
     uint32_t m_buffer { 0 };
     uint32_t m_bufferType { 0 };
     uint32_t m_usage { 0 };
+    size_t m_size { 0 };
+    bool m_immutable { false };
 };
 
-#endif // __BUFFER_H__
\ No newline at end of file
+#endif // __BUFFER_H__
@@ -0,0 +1,121 @@
+#include "buffer_heap.h"
+
+BufferHeapUPtr BufferHeap::Create(uint32_t bufferType, uint32_t usage,
+    size_t pageSize, size_t minBlockSize) {
+    auto heap = BufferHeapUPtr(new BufferHeap());
+    heap->m_bufferType = bufferType;
+    heap->m_usage = usage;
+    heap->m_pageSize = pageSize;
+    heap->m_minBlockSize = minBlockSize;
+    if (!heap->AddPage(pageSize))
+        return nullptr;
+    return std::move(heap);
+}
+
+// element array binding은 VAO 상태라서, 다른 mesh의 VAO가 바인딩된
+// 채로 인덱스 버퍼를 만들거나 쓰면 그 VAO의 인덱스 버퍼가 바뀜
+static void UnbindVertexArrayFor(uint32_t bufferType) {
+    if (bufferType == GL_ELEMENT_ARRAY_BUFFER)
+        glBindVertexArray(0);
+}
+
+bool BufferHeap::AddPage(size_t size) {
+    UnbindVertexArrayFor(m_bufferType);
+    Page page;
+    page.allocator = std::make_unique<BuddyAllocator>(size, m_minBlockSize);
+    // 할당자가 2의 거듭제곱으로 올린 크기만큼 GL 버퍼를 잡음
+    page.buffer = Buffer::CreateWithData(m_bufferType, m_usage,
+        nullptr, page.allocator->GetCapacity());
+    if (!page.buffer) {
+        SPDLOG_ERROR("failed to reserve buffer heap page of {} bytes", size);
+        return false;
+    }
+    // 비어서 반납된 자리가 있으면 재사용 (page 번호는 handle에 들어 있음)
+    for (auto& slot : m_pages) {
+        if (!slot.buffer) {
+            slot = std::move(page);
+            return true;
+        }
+    }
+    m_pages.push_back(std::move(page));
+    return true;
+}
+
+BufferAllocation BufferHeap::Allocate(size_t size, size_t alignment) {
+    BufferAllocation allocation;
+    for (int attempt = 0; attempt < 2; attempt++) {
+        for (uint32_t i = 0; i < (uint32_t)m_pages.size(); i++) {
+            auto& page = m_pages[i];
+            if (!page.buffer)
+                continue;
+            size_t offset = page.allocator->Allocate(size, alignment);
+            if (offset == BuddyAllocator::kInvalidOffset)
+                continue;
+            allocation.buffer = page.buffer;
+            allocation.offset = offset;
+            allocation.size = size;
+            allocation.page = i;
+            return allocation;
+        }
+        // 모든 page가 차 있으면 하나 더 (페이지보다 큰 요청은 전용 page)
+        if (attempt == 0 && !AddPage(std::max(m_pageSize, std::max(size, alignment))))
+            break;
+    }
+    SPDLOG_ERROR("buffer heap allocation of {} bytes failed", size);
+    return allocation;
+}
+
+BufferAllocation BufferHeap::AllocateWithData(const void* data, size_t size, size_t alignment) {
+    auto allocation = Allocate(size, alignment);
+    if (allocation.IsValid()) {
+        UnbindVertexArrayFor(m_bufferType);
+        allocation.buffer->UpdateData(data, size, allocation.offset);
+    }
+    return allocation;
+}
+
+BufferAllocationPtr BufferHeap::AllocateShared(const void* data, size_t size, size_t alignment) {
+    auto allocation = AllocateWithData(data, size, alignment);
+    if (!allocation.IsValid())
+        return nullptr;
+    return BufferAllocationPtr(new BufferAllocation(allocation), [this](BufferAllocation* shared) {
+        Free(*shared);
+        delete shared;
+    });
+}
+
+void BufferHeap::Free(BufferAllocation& allocation) {
+    if (!allocation.IsValid() || allocation.page >= m_pages.size())
+        return;
+    uint32_t index = allocation.page;
+    auto& page = m_pages[index];
+    page.allocator->Free(allocation.offset);
+    allocation = BufferAllocation();
+    if (index != 0 && page.allocator->GetStats().allocationCount == 0)
+        page = Page();
+}
+
+BufferHeap::Stats BufferHeap::GetStats() const {
+    Stats stats;
+    size_t largestFreeBlock = 0;
+    for (auto& page : m_pages) {
+        if (!page.buffer)
+            continue;
+        auto blocks = page.allocator->GetStats();
+        stats.pageCount++;
+        stats.blocks.capacity += blocks.capacity;
+        stats.blocks.usedBytes += blocks.usedBytes;
+        stats.blocks.requestedBytes += blocks.requestedBytes;
+        stats.blocks.freeBytes += blocks.freeBytes;
+        stats.blocks.allocationCount += blocks.allocationCount;
+        stats.blocks.freeBlockCount += blocks.freeBlockCount;
+        largestFreeBlock = std::max(largestFreeBlock, blocks.largestFreeBlock);
+    }
+    stats.blocks.largestFreeBlock = largestFreeBlock;
+    if (stats.blocks.freeBytes > 0)
+        stats.blocks.fragmentation = 1.0f - (float)largestFreeBlock / stats.blocks.freeBytes;
+    if (stats.blocks.usedBytes > 0)
+        stats.blocks.internalWaste = (float)(stats.blocks.usedBytes - stats.blocks.requestedBytes) /
+            stats.blocks.usedBytes;
+    return stats;
+}
@@ -0,0 +1,61 @@
+#ifndef __BUFFER_HEAP_H__
+#define __BUFFER_HEAP_H__
+
+#include "common.h"
+#include "buffer.h"
+#include "buddy_allocator.h"
+
+// sub-range of one of the heap's GL buffers
+struct BufferAllocation {
+    BufferPtr buffer;
+    size_t offset { 0 };
+    size_t size { 0 };
+    uint32_t page { 0 };
+
+    bool IsValid() const { return buffer != nullptr; }
+};
+// an allocation shared by several owners (e.g. one index buffer used by
+// many meshes), returned to its heap when the last copy goes away
+using BufferAllocationPtr = std::shared_ptr<BufferAllocation>;
+
+// a few large GL buffers ("pages") split by a buddy allocator, so many
+// small meshes share buffer objects instead of one glGenBuffers each.
+// requests larger than a page get a dedicated page of their own size.
+CLASS_PTR(BufferHeap)
+class BufferHeap {
+public:
+    struct Stats {
+        uint32_t pageCount { 0 };
+        BuddyAllocator::Stats blocks;  // summed over all pages
+    };
+
+    static BufferHeapUPtr Create(uint32_t bufferType, uint32_t usage,
+        size_t pageSize = 16 << 20, size_t minBlockSize = 256);
+
+    BufferAllocation Allocate(size_t size, size_t alignment = 16);
+    // copies data into the allocation, size must fit
+    BufferAllocation AllocateWithData(const void* data, size_t size, size_t alignment = 16);
+    // nullptr on failure. the heap must outlive the returned pointer
+    BufferAllocationPtr AllocateShared(const void* data, size_t size, size_t alignment = 16);
+    // pages other than the first are released once they become empty
+    void Free(BufferAllocation& allocation);
+
+    uint32_t GetBufferType() const { return m_bufferType; }
+    Stats GetStats() const;
+
+private:
+    BufferHeap() {}
+    bool AddPage(size_t size);
+
+    struct Page {
+        BufferPtr buffer;
+        std::unique_ptr<BuddyAllocator> allocator;
+    };
+    std::vector<Page> m_pages;
+    uint32_t m_bufferType { 0 };
+    uint32_t m_usage { 0 };
+    size_t m_pageSize { 0 };
+    size_t m_minBlockSize { 0 };
+};
+
+#endif // __BUFFER_HEAP_H__
@@ -2,6 +2,13 @@
 #include "image.h"
 #include <imgui.h>
 
+// 매 프레임 쓰는 uniform 이름은 컴파일 시간에 해시
+static constexpr UniformName kTexUniform("tex");
+static constexpr UniformName kModelUniform("model");
+static constexpr UniformName kTex2Uniform("tex2");
+static constexpr UniformName kDetailBlendUniform("detailBlend");
+static constexpr UniformName kAtlasRegionUniform("atlasRegion");
+
 ContextUPtr Context::Create() {
   auto context = ContextUPtr(new Context());
   if (!context->Init())
@@ -72,41 +79,187 @@ void Context::MouseButton(int button, int action, double x, double y) {
 }
 
 bool Context::Init() {
+    // program을 링크하기 전에 등록해야 block이 binding point에 연결됨
+    BlockLayoutBuilder frameLayout(BlockLayout::Std140);
+    m_frameDataLayout.view = frameLayout.Add(BlockMemberType::Mat4);
+    m_frameDataLayout.projection = frameLayout.Add(BlockMemberType::Mat4);
+    m_frameDataLayout.viewProjection = frameLayout.Add(BlockMemberType::Mat4);
+    m_frameDataLayout.viewport = frameLayout.Add(BlockMemberType::Vec4);
+    m_frameDataLayout.time = frameLayout.Add(BlockMemberType::Float);
+    m_frameDataLayout.srgbOutput = frameLayout.Add(BlockMemberType::Float);
+    m_frameData = UniformBuffer::Create("FrameData", frameLayout.GetSize());
+    if (!m_frameData)
+        return false;
+    //텍스처를 만들기 전에 (FBO가 bind되기 전) default framebuffer의 인코딩을 확인
+    SPDLOG_INFO("sRGB framebuffer: {}", Texture::IsSrgbFramebuffer() ? "yes" : "no");
 
-    ShaderPtr vertShader = Shader::CreateFromFile("./shader/texture.vs", GL_VERTEX_SHADER);
-    ShaderPtr fragShader = Shader::CreateFromFile("./shader/texture.fs", GL_FRAGMENT_SHADER);
-    if (!vertShader || !fragShader)
+    // 링크된 program을 디스크에 저장해 두고 다음 실행부터는 컴파일을 건너뜀
+    m_programCache = ProgramCache::Create("./cache");
+    if (!m_programCache)
         return false;
-    SPDLOG_INFO("vertex shader id: {}", vertShader->Get());
-    SPDLOG_INFO("fragment shader id: {}", fragShader->Get());
 
-    m_program = Program::Create({fragShader, vertShader});
-    if (!m_program)
+    // 모든 program의 컴파일을 한 번에 요청하고 처음 사용할 때 결과 확인
+    m_programBatch = ProgramBatch::Create(m_programCache.get());
+    if (!m_programBatch)
+        return false;
+    // texture.fs를 쓰는 program은 기능(ShaderFeature) 조합마다 따로 컴파일
+    m_textureVariants = ProgramVariants::Create(m_programBatch.get(), {
+        { "./shader/texture.fs", GL_FRAGMENT_SHADER },
+        { "./shader/texture.vs", GL_VERTEX_SHADER } });
+    // 같은 fragment shader, 정점은 gl_VertexID로 계산
+    m_proceduralVariants = ProgramVariants::Create(m_programBatch.get(), {
+        { "./shader/texture.fs", GL_FRAGMENT_SHADER },
+        { "./shader/procedural.vs", GL_VERTEX_SHADER } });
+    if (!m_textureVariants || !m_proceduralVariants)
+        return false;
+    m_instancedSlot = m_programBatch->Add({
+        { "./shader/instanced.fs", GL_FRAGMENT_SHADER },
+        { "./shader/instanced.vs", GL_VERTEX_SHADER } });
+    m_programBatch->Submit();
+    m_proceduralVariants->Get(0);
+
+    // 기본 program은 다른 program이 준비될 때까지 대신 쓰이므로 여기서 기다림
+    auto program = m_textureVariants->Wait(0);
+    if (!program)
         return false;
-    SPDLOG_INFO("program id: {}", m_program->Get());
+    SPDLOG_INFO("program id: {}", program->Get());
+
+    // shader 파일을 저장하면 다시 링크 (실패하면 이전 program 유지)
+    m_shaderWatcher = ShaderWatcher::Create("./shader");
+
+    auto& cacheStats = m_programCache->GetStats();
+    SPDLOG_INFO("program cache: {} hits, {} misses, {} rejected, {:.1f} ms",
+        cacheStats.hits, cacheStats.misses, cacheStats.rejected, cacheStats.loadMs);
 
     glClearColor(0.5f, 0.5f, 0.9f, 0.0f);
 
-    // 이미지 로딩
-    auto image0 = Image::Load("./image/wood.png");
-    if (!image0) 
+    // 이미지는 worker thread에서 디코딩, 그 전까지는 체크무늬 텍스처
+    m_textureLoader = TextureLoader::Create();
+    if (!m_textureLoader)
         return false;
-    SPDLOG_INFO("image: {}x{}, {} channels",
-        image0->GetWidth(), image0->GetHeight(), image0->GetChannelCount());
+    m_texture0 = m_textureLoader->Load("./image/wood.png");
+    m_texture1 = m_textureLoader->Load("./image/metal.jpg");
+    m_texture2 = m_textureLoader->Load("./image/earth.jpg");
 
-    m_texture0 = Texture::CreateFromImage(image0.get());
+    program->Use(); 	
+    program->SetUniform(kTexUniform, 0);
 
-    auto image1 = Image::Load("./image/metal.jpg");
-    m_texture1 = Texture::CreateFromImage(image1.get());
-    auto image2 = Image::Load("./image/earth.jpg");
-    m_texture2 = Texture::CreateFromImage(image2.get());
-
-    m_program->Use(); 	
-    m_program->SetUniform("tex", 0);
+    // 캐시된 도형과 장면은 모두 이 heap들에서 영역을 나눠 씀
+    m_vertexHeap = BufferHeap::Create(GL_ARRAY_BUFFER, GL_STATIC_DRAW);
+    m_indexHeap = BufferHeap::Create(GL_ELEMENT_ARRAY_BUFFER, GL_STATIC_DRAW);
+    if (!m_vertexHeap || !m_indexHeap)
+        return false;
+    m_meshCache = MeshCache::Create(m_vertexHeap.get(), m_indexHeap.get());
+    m_drawTimer = GpuTimer::Create();
+    m_proceduralMesh = ProceduralMesh::Create();
+    m_instanceBuffer = Buffer::CreateWithData(GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW,
+        nullptr, sizeof(InstanceData) * kMaxInstances);
+    if (!m_instanceBuffer)
+        return false;
+    m_instanceStream = StreamBuffer::Create(GL_ARRAY_BUFFER, sizeof(InstanceData) * kMaxInstances);
+    if (!m_instanceStream)
+        return false;
+    SPDLOG_INFO("instance stream buffer: {}",
+        m_instanceStream->IsPersistent() ? "persistent mapped" : "unsynchronized map");
 
     return true;
 }
 
+void Context::FillInstanceGrid(InstanceData* out, int count, float time) const {
+    // 원점을 중심으로 한 정육면체 격자, instance마다 회전과 색을 조금씩 다르게
+    // time이 0이 아니면 격자를 따라 물결치듯 위아래로 움직임
+    const float spacing = 1.5f;
+    int side = 1;
+    while (side * side * side < count)
+        side++;
+    float offset = (side - 1) * spacing * 0.5f;
+
+    for (int i = 0; i < count; i++) {
+        int x = i % side, y = (i / side) % side, z = i / (side * side);
+        glm::vec3 pos = glm::vec3(x, y, z) * spacing - glm::vec3(offset);
+        if (time != 0.0f)
+            pos.y += 0.25f * sinf(time * 2.0f + (x + z) * 0.5f);
+        out[i].model =
+            glm::translate(glm::mat4(1.0f), pos) *
+            glm::rotate(glm::mat4(1.0f), glm::radians(37.0f * i + time * 60.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        out[i].color = glm::vec4(
+            0.5f + 0.5f * (float)x / side,
+            0.5f + 0.5f * (float)y / side,
+            0.5f + 0.5f * (float)z / side, 1.0f);
+    }
+}
+
+void Context::BuildInstanceGrid(int count) {
+    std::vector<InstanceData> instances(count);
+    FillInstanceGrid(instances.data(), count, 0.0f);
+    m_instanceBuffer->UpdateData(instances.data(), sizeof(InstanceData) * count);
+    m_instanceCount = count;
+}
+
+void Context::BuildScene(int count) {
+    // 도형 4종류를 한 번씩만 생성하고 위치만 바꿔 배치
+    MeshData shapes[] = {
+        GenerateBox(),
+        GenerateCylinder(0.4f, 0.4f, 24, 1.0f),
+        GenerateSphere(0.5f, 24, 12),
+        GenerateTorus(0.3f, 0.15f, 24, 12),
+    };
+    const float spacing = 1.5f;
+    int side = 1;
+    while (side * side < count)
+        side++;
+    float offset = (side - 1) * spacing * 0.5f;
+
+    std::vector<MeshBatchItem> items(count);
+    for (int i = 0; i < count; i++) {
+        glm::vec3 pos = glm::vec3(i % side, 0.0f, i / side) * spacing -
+            glm::vec3(offset, 0.0f, offset);
+        items[i].data = &shapes[i % 4];
+        items[i].transform =
+            glm::translate(glm::mat4(1.0f), pos) *
+            glm::rotate(glm::mat4(1.0f), glm::radians(23.0f * i), glm::vec3(0.0f, 1.0f, 0.0f));
+    }
+    // 이전 장면의 영역을 먼저 반납해야 heap에서 다시 쓸 수 있음
+    m_sceneBatch.reset();
+    m_sceneBatch = MeshBatch::Create(items, m_vertexHeap.get(), m_indexHeap.get());
+    m_sceneObjectCount = count;
+}
+
+void Context::UpdateAtlas() {
+    if (m_atlas || m_atlasFailed)
+        return;
+    if (m_atlasImages.empty()) {
+        // texture_select 순서와 같게
+        for (auto filepath : { "./image/wood.png", "./image/metal.jpg", "./image/earth.jpg" })
+            m_atlasImages.push_back(m_textureLoader->LoadImageAsync(filepath));
+        return;
+    }
+    for (auto& image : m_atlasImages) {
+        if (image.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return;
+    }
+    std::vector<ImageUPtr> images;
+    std::vector<const Image*> pointers;
+    for (auto& future : m_atlasImages) {
+        images.push_back(future.get());
+        if (!images.back()) {
+            // 읽지 못한 이미지가 있으면 atlas 없이 (개별 텍스처로) 그림
+            SPDLOG_ERROR("failed to load atlas images");
+            m_atlasImages.clear();
+            m_atlasFailed = true;
+            return;
+        }
+        pointers.push_back(images.back().get());
+    }
+    m_atlasImages.clear();
+    // 원본은 1024 크기라 atlas에서는 512로 줄여서 사용
+    m_atlas = TextureAtlas::Create(pointers, 8, 512);
+    m_atlasFailed = !m_atlas;
+    if (m_atlas)
+        SPDLOG_INFO("texture atlas: {}x{}, {} levels", m_atlas->GetWidth(),
+            m_atlas->GetHeight(), m_atlas->GetLevelCount());
+}
+
 void Context::Render() {
     //imgui에 필요한 변수들
     const char* texture[] = { "wood", "metal", "earth" };
@@ -114,6 +267,70 @@ void Context::Render() {
     static bool animation = false;
     const char* primitive[] = { "box", "cylinder", "sphere", "donut" };
     static int primitive_select = 0; 
+    //도형마다 삼각형 리스트 / strip 선택 (box는 항상 리스트)
+    static bool strip_select[] = { false, false, false, false };
+
+    //정점을 vertex shader에서 계산 (box 제외)
+    static bool procedural_mode = false;
+    //같은 도형을 격자로 여러 개 그리기
+    static bool instancing = false;
+    static int instance_count = 1000;
+    static bool animate_instances = false;
+    //box / cylinder / sphere / donut을 섞은 정적 장면
+    static bool scene_mode = false;
+    static int scene_object_count = 256;
+    //두 번째 텍스처를 섞거나 법선을 색으로 표시 (shader variant)
+    static bool detail_texture = false;
+    static int detail_select = 1;
+    static float detail_blend = 0.5f;
+    static bool normal_view = false;
+    //세 텍스처를 atlas 하나에서 (texture 선택은 uv 영역만 바꿈)
+    static bool texture_atlas = false;
+
+    //현재 파라미터에 해당하는 도형 (캐시에 있으면 재사용)
+    MeshKey key;
+    auto topology = strip_select[primitive_select] ?
+        PrimitiveTopology::TriangleStrip : PrimitiveTopology::Triangles;
+    switch (primitive_select) {
+        case 0: key = MeshKey::Box(); break;
+        case 1: key = MeshKey::Cylinder(c_upperRadius, c_lowerRadius, c_segment, c_height, topology); break;
+        case 2: key = MeshKey::Sphere(s_radius, s_sectorCount, s_stackCount, topology); break;
+        case 3: key = MeshKey::Torus(d_ringRadius, d_tubeRadius, d_ringSegment, d_tubeSegment, topology); break;
+    }
+    //디코딩이 끝난 이미지를 예산 안에서 조금씩 업로드
+    m_textureLoader->Update();
+    if (texture_atlas)
+        UpdateAtlas();
+
+    //수정된 shader가 있으면 백그라운드에서 다시 링크
+    if (m_shaderWatcher) {
+        auto changes = m_shaderWatcher->TakeChanges();
+        if (!changes.empty())
+            m_programBatch->Reload(changes);
+    }
+    //켜진 기능만 들어간 shader variant 선택
+    uint32_t features = 0;
+    if (normal_view)
+        features |= kShaderFeatureNormalView;
+    else if (detail_texture)
+        features |= kShaderFeatureDetailTexture;
+    else if (texture_atlas && m_atlas)
+        features |= kShaderFeatureAtlas;
+    //필요할 때만 컴파일 완료 여부를 확인, 아직이면 기본 program으로 그림
+    //(fallback은 feature가 없으므로 atlas/detail 텍스처도 바인딩하지 않음)
+    uint32_t basicFeatures = features;
+    Program* basicProgram = m_textureVariants->Get(features);
+    if (!basicProgram) {
+        basicProgram = m_textureVariants->Get(0);
+        basicFeatures = 0;
+    }
+    bool proceduralSupported = procedural_mode && ProceduralMesh::IsSupported(key.type);
+    Program* proceduralProgram = proceduralSupported ?
+        m_proceduralVariants->Get(features) : nullptr;
+    Program* instancedProgram = instancing && !scene_mode ?
+        m_programBatch->Get(m_instancedSlot) : nullptr;
+    bool procedural = proceduralProgram != nullptr;
+    const Mesh* mesh = procedural ? nullptr : m_meshCache->Get(key);
     
     //imgui 코드
     if (ImGui::Begin("ui window")) {
@@ -140,13 +357,58 @@ void Context::Render() {
         }
         ImGui::Separator();
         ImGui::Combo("primitive", &primitive_select, primitive, IM_ARRAYSIZE(primitive));
+        if (mesh) {
+            ImGui::LabelText("# vertices", "%d", mesh->GetVertexCount());
+            ImGui::LabelText("# triangles", "%d", mesh->GetTriangleCount());
+            ImGui::LabelText("vertex bytes", "%zu", mesh->GetVertexBufferSize());
+            ImGui::LabelText("index type", "%s",
+                mesh->GetIndexType() == GL_UNSIGNED_SHORT ? "uint16" : "uint32");
+            ImGui::LabelText("index bytes", "%zu", mesh->GetIndexBufferSize());
+            ImGui::LabelText("draw time (gpu)", "%.3f ms", m_drawTimer->GetElapsedMs());
+        }
+        if (procedural) {
+            ImGui::LabelText("# vertices (gpu)", "%d", ProceduralMesh::GetVertexCount(key));
+            ImGui::LabelText("draw time (gpu)", "%.3f ms", m_drawTimer->GetElapsedMs());
+        }
+        if (primitive_select != 0) {
+            ImGui::Checkbox("procedural (gpu)", &procedural_mode);
+            if (proceduralSupported && !proceduralProgram)
+                ImGui::LabelText("procedural program", "compiling...");
+            if (!procedural)
+                ImGui::Checkbox("triangle strips", &strip_select[primitive_select]);
+        }
+        if (!procedural) {
+            ImGui::Checkbox("instancing", &instancing);
+            if (instancing && m_programBatch->IsPending(m_instancedSlot))
+                ImGui::LabelText("instanced program", "compiling...");
+            if (instancing) {
+                ImGui::DragInt("instances", &instance_count, 10.0f, 1, kMaxInstances);
+                ImGui::Checkbox("animate instances (stream)", &animate_instances);
+                if (animate_instances)
+                    ImGui::LabelText("stream stalls", "%u (%s)", m_instanceStream->GetStallCount(),
+                        m_instanceStream->IsPersistent() ? "persistent" : "unsynchronized");
+            }
+        }
+        ImGui::Checkbox("mixed scene (multi-draw)", &scene_mode);
+        if (scene_mode) {
+            ImGui::DragInt("objects", &scene_object_count, 1.0f, 1, 4096);
+            if (m_sceneBatch) {
+                ImGui::LabelText("scene draws", "%d (%s)", m_sceneBatch->GetDrawCount(),
+                    m_sceneBatch->IsIndirect() ? "indirect" : "base vertex");
+                ImGui::LabelText("scene triangles", "%zu", m_sceneBatch->GetTriangleCount());
+            }
+        }
+        //캐시된 도형과 장면이 함께 쓰는 heap
+        for (auto heap : { m_vertexHeap.get(), m_indexHeap.get() }) {
+            auto stats = heap->GetStats();
+            const char* name = heap == m_vertexHeap.get() ? "vertex heap" : "index heap";
+            ImGui::LabelText(name, "%u pages, %.1f / %.1f MB, frag %.2f, waste %.2f",
+                stats.pageCount, stats.blocks.usedBytes / 1048576.0f,
+                stats.blocks.capacity / 1048576.0f,
+                stats.blocks.fragmentation, stats.blocks.internalWaste);
+        }
         switch (primitive_select) {
-            case 0: ImGui::LabelText("# vertices", "%d", m_boxVerticesCount);
-                    ImGui::LabelText("trianles", "%d", m_boxTrianglesCount);
-                    break;
-            case 1: ImGui::LabelText("# vertices", "%d", m_cylinderVerticesCount);
-                    ImGui::LabelText("# triangles", "%d", m_ctylinderTrianglesCount);
-                    ImGui::DragFloat("upperRadius", &c_upperRadius, 0.1f, 0.1f, 100.0f);
+            case 1: ImGui::DragFloat("upperRadius", &c_upperRadius, 0.1f, 0.1f, 100.0f);
                     ImGui::DragFloat("lowerRadius", &c_lowerRadius, 0.1f, 0.1f, 100.0f);
                     ImGui::DragInt("segment", &c_segment, 1, 3, 128);
                     ImGui::DragFloat("height", &c_height, 0.1f, 0.1f, 100.0f);
@@ -154,9 +416,7 @@ void Context::Render() {
                         c_upperRadius = 0.5f; c_lowerRadius = 0.5f;
                         c_segment = 32; c_height = 1.0f;
                     } break;
-            case 2: ImGui::LabelText("# vertices", "%d", m_sphereVerticesCount);
-                    ImGui::LabelText("# Triangles", "%d", m_sphereTrianglesCount);
-                    ImGui::DragFloat("radius", &s_radius, 0.1f, 0.1f, 100.0f);
+            case 2: ImGui::DragFloat("radius", &s_radius, 0.1f, 0.1f, 100.0f);
                     ImGui::DragInt("stackcount", &s_stackCount, 1, 3, 100);
                     ImGui::DragInt("sectorcount", &s_sectorCount, 1, 3, 100);
                     if (ImGui::Button("reset sphere")) {
@@ -164,8 +424,40 @@ void Context::Render() {
                         s_stackCount = 16; s_sectorCount = 32;
                     }
                     break;
+            case 3: ImGui::DragFloat("ringRadius", &d_ringRadius, 0.01f, 0.01f, 100.0f);
+                    ImGui::DragFloat("tubeRadius", &d_tubeRadius, 0.01f, 0.01f, 100.0f);
+                    ImGui::DragInt("ringSegment", &d_ringSegment, 1, 3, 256);
+                    ImGui::DragInt("tubeSegment", &d_tubeSegment, 1, 3, 128);
+                    if (ImGui::Button("reset donut")) {
+                        d_ringRadius = 0.3f; d_tubeRadius = 0.15f;
+                        d_ringSegment = 32; d_tubeSegment = 16;
+                    }
+                    break;
         }
         ImGui::Combo("texture", &texture_select, texture, IM_ARRAYSIZE(texture));
+        auto uploads = m_textureLoader->GetUploadQueue();
+        if (m_textureLoader->GetPendingCount() > 0)
+            ImGui::LabelText("decoding images", "%zu", m_textureLoader->GetPendingCount());
+        if (m_textureLoader->GetCookedCount() > 0)
+            ImGui::LabelText("cooked textures", "%u", m_textureLoader->GetCookedCount());
+        if (uploads->GetPendingCount() > 0)
+            ImGui::LabelText("uploading images", "%zu (%.1f MB left, %.1f MB/frame)",
+                uploads->GetPendingCount(), uploads->GetPendingBytes() / 1048576.0f,
+                uploads->GetBytesPerFrame() / 1048576.0f);
+        ImGui::Checkbox("detail texture", &detail_texture);
+        if (detail_texture) {
+            ImGui::Combo("detail", &detail_select, texture, IM_ARRAYSIZE(texture));
+            ImGui::SliderFloat("detail blend", &detail_blend, 0.0f, 1.0f);
+        }
+        ImGui::Checkbox("show normals", &normal_view);
+        ImGui::Checkbox("texture atlas", &texture_atlas);
+        if (texture_atlas && m_atlas)
+            ImGui::LabelText("atlas", "%dx%d, %d levels", m_atlas->GetWidth(),
+                m_atlas->GetHeight(), m_atlas->GetLevelCount());
+        else if (texture_atlas)
+            ImGui::LabelText("atlas", "loading");
+        ImGui::LabelText("shader variants", "%zu",
+            m_textureVariants->GetVariantCount() + m_proceduralVariants->GetVariantCount());
         ImGui::Separator();
         ImGui::DragFloat3("scale", glm::value_ptr(m_scale1), 0.01f);
         ImGui::DragFloat3("rotation", glm::value_ptr(m_radius1), 0.01f);
@@ -178,29 +470,80 @@ void Context::Render() {
             m_scale1 = glm::vec3(1.0f, 1.0f, 1.0f);
         }
         ImGui::Separator();
+        const auto& cacheStats = m_meshCache->GetStats();
+        ImGui::LabelText("mesh cache hits", "%u", cacheStats.hits);
+        ImGui::LabelText("mesh cache misses", "%u", cacheStats.misses);
+        ImGui::LabelText("mesh regenerations", "%u", cacheStats.regenerations);
+        ImGui::LabelText("in-place updates", "%u", cacheStats.inPlaceUpdates);
+        ImGui::LabelText("shared index buffers", "%u", cacheStats.sharedIndexBuffers);
+        ImGui::LabelText("skipped uniform uploads", "%u", basicProgram->GetSkippedUniformCount());
+        if (ImGui::Button("reset cache stats")) {
+            m_meshCache->ResetStats();
+        }
+        bool compactVertices = m_meshCache->GetVertexFormat() == VertexFormat::Compact;
+        if (ImGui::Checkbox("compact vertices", &compactVertices))
+            m_meshCache->SetVertexFormat(compactVertices ? VertexFormat::Compact : VertexFormat::Float);
+        bool optimizeIndices = m_meshCache->GetOptimizeIndices();
+        if (ImGui::Checkbox("optimize index order", &optimizeIndices))
+            m_meshCache->SetOptimizeIndices(optimizeIndices);
+        if (optimizeIndices) {
+            const auto& report = m_meshCache->GetLastOptimizeReport();
+            ImGui::LabelText("ACMR", "%.3f -> %.3f", report.before.acmr, report.after.acmr);
+            ImGui::LabelText("ATVR", "%.3f -> %.3f", report.before.atvr, report.after.atvr);
+        }
+        ImGui::Separator();
     }
     ImGui::End();
 
     //기능 구현 코드
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glEnable(GL_DEPTH_TEST);
+    //sRGB framebuffer면 sRGB 텍스처를 linear로 샘플링하므로 장면만 다시 인코딩 (ImGui는 그대로)
+    bool srgbOutput = Texture::IsSrgbFramebuffer();
+    if (srgbOutput)
+        glEnable(GL_FRAMEBUFFER_SRGB);
+
+
+    bool instanced = instancedProgram && mesh;
+    auto program = scene_mode ? basicProgram :
+        procedural ? proceduralProgram :
+        instanced ? instancedProgram : basicProgram;
+    program->Use();
+    //바인딩은 실제로 고른 program의 feature 기준 (instanced shader에는 variant가 없음)
+    uint32_t programFeatures = program == basicProgram ? basicFeatures :
+        program == proceduralProgram ? features : 0;
+
+    //텍스처 선택 (atlas면 4번 유닛에 한 장, 영역만 바꿈)
+    if (programFeatures & kShaderFeatureAtlas) {
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_2D, m_atlas->GetTexture()->Get());
+        program->SetUniform(kTexUniform, 4);
+        program->SetUniform(kAtlasRegionUniform, m_atlas->GetRegion(texture_select).uvTransform);
+    }
+    else {
+        switch(texture_select) {
 
-
-    //텍스처 선택
-    switch(texture_select) {
-
-        case 0: glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, m_texture0->Get());
-                m_program->SetUniform("tex", 0);
-                break;
-        case 1: glActiveTexture(GL_TEXTURE1);
-                glBindTexture(GL_TEXTURE_2D, m_texture1->Get());
-                m_program->SetUniform("tex", 1);
-                break;
-        case 2: glActiveTexture(GL_TEXTURE2);
-                glBindTexture(GL_TEXTURE_2D, m_texture2->Get());
-                m_program->SetUniform("tex", 2);
-                break;
+            case 0: glActiveTexture(GL_TEXTURE0);
+                    glBindTexture(GL_TEXTURE_2D, m_texture0->Get());
+                    program->SetUniform(kTexUniform, 0);
+                    break;
+            case 1: glActiveTexture(GL_TEXTURE1);
+                    glBindTexture(GL_TEXTURE_2D, m_texture1->Get());
+                    program->SetUniform(kTexUniform, 1);
+                    break;
+            case 2: glActiveTexture(GL_TEXTURE2);
+                    glBindTexture(GL_TEXTURE_2D, m_texture2->Get());
+                    program->SetUniform(kTexUniform, 2);
+                    break;
+        }
+    }
+    //detail 텍스처는 3번 유닛 (variant에 tex2가 없으면 무시됨)
+    if (programFeatures & kShaderFeatureDetailTexture) {
+        const Texture* details[] = { m_texture0.get(), m_texture1.get(), m_texture2.get() };
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, details[detail_select]->Get());
+        program->SetUniform(kTex2Uniform, 3);
+        program->SetUniform(kDetailBlendUniform, detail_blend);
     }
 
     m_cameraFront =
@@ -215,353 +558,73 @@ void Context::Render() {
         m_cameraPos + m_cameraFront,
         m_cameraUp);
 
+    //카메라 관련 값은 프레임마다 한 번만 UBO에 씀
+    m_frameData->Set(m_frameDataLayout.view, m_view);
+    m_frameData->Set(m_frameDataLayout.projection, m_projection);
+    m_frameData->Set(m_frameDataLayout.viewProjection, m_projection * m_view);
+    m_frameData->Set(m_frameDataLayout.viewport, glm::vec4(0.0f, 0.0f, (float)m_width, (float)m_height));
+    m_frameData->Set(m_frameDataLayout.time, (float)glfwGetTime());
+    m_frameData->Set(m_frameDataLayout.srgbOutput, srgbOutput ? 1.0f : 0.0f);
+    m_frameData->Upload();
+
     //스케일 조절 변수
     glm::mat4 m_scale2 { glm::scale(glm::mat4(1.0f), m_scale1) };
-    //m_rotation = m_radius1;
-    //도형 선택 및 애니메이션 적용
-    switch (primitive_select) {
-
-        case 0: CreateBox();
-                if (!animation) {
-                    if ( m_radius1 == glm::vec3( 0.0f, 0.0f, 0.0f) ) {
-                        m_transform = m_projection * m_view * m_scale2;
-                        m_program->SetUniform("transform", m_transform);
-                        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-                    }
-                    else {
-                        auto model = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), m_radius1);
-                        m_transform = m_projection * m_view * m_scale2 * model;
-                        m_program->SetUniform("transform", m_transform);
-                        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-                    }
-                }
-                else {
-                    if (m_rotation == glm::vec3( 0.0f, 0.0f, 0.0f) && m_radius1 == glm::vec3( 0.0f, 0.0f, 0.0f)) {
-                            m_transform = m_projection * m_view * m_scale2;
-                            m_program->SetUniform("transform", m_transform);
-                            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-                    }
-                    else if ( m_rotation == glm::vec3( 0.0f, 0.0f, 0.0f) && m_radius1 != glm::vec3( 0.0f, 0.0f, 0.0f)) {
-                            auto model = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), m_radius1);
-                            m_transform = m_projection * m_view * m_scale2 * model;
-                            m_program->SetUniform("transform", m_transform);
-                            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-                    }
-                    else {
-                        auto model = glm::rotate(glm::mat4(1.0f), glm::radians((float)glfwGetTime() * 120.0f), m_rotation);
-                        m_transform = m_projection * m_view * m_scale2 * model;
-                        m_program->SetUniform("transform", m_transform);
-                        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-                    }
-                }break;
-        case 1: CreateCylinder(c_upperRadius, c_lowerRadius, c_segment, c_height);
-                if (!animation) {
-                    if ( m_radius1 == glm::vec3( 0.0f, 0.0f, 0.0f) ) {
-                        m_transform = m_projection * m_view * m_scale2;
-                        m_program->SetUniform("transform", m_transform);
-                        glDrawElements(GL_TRIANGLES, m_clyinderIndexCount, GL_UNSIGNED_INT, 0);
-                    }
-                    else {
-                        auto model = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), m_radius1);
-                        m_transform = m_projection * m_view * m_scale2 * model;
-                        m_program->SetUniform("transform", m_transform);
-                        glDrawElements(GL_TRIANGLES, m_clyinderIndexCount, GL_UNSIGNED_INT, 0);
-                    }
-                }
-                else {
-                    if (m_rotation == glm::vec3( 0.0f, 0.0f, 0.0f) && m_radius1 == glm::vec3( 0.0f, 0.0f, 0.0f)) {
-                            m_transform = m_projection * m_view * m_scale2;
-                            m_program->SetUniform("transform", m_transform);
-                            glDrawElements(GL_TRIANGLES, m_clyinderIndexCount, GL_UNSIGNED_INT, 0);
-                    }
-                    else if ( m_rotation == glm::vec3( 0.0f, 0.0f, 0.0f) && m_radius1 != glm::vec3( 0.0f, 0.0f, 0.0f)) {
-                            auto model = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), m_radius1);
-                            m_transform = m_projection * m_view * m_scale2 * model;
-                            m_program->SetUniform("transform", m_transform);
-                            glDrawElements(GL_TRIANGLES, m_clyinderIndexCount, GL_UNSIGNED_INT, 0);
-                    }
-                    else {
-                        auto model = glm::rotate(glm::mat4(1.0f), glm::radians((float)glfwGetTime() * 120.0f), m_rotation);
-                        m_transform = m_projection * m_view * m_scale2 * model;
-                        m_program->SetUniform("transform", m_transform);
-                        glDrawElements(GL_TRIANGLES, m_clyinderIndexCount, GL_UNSIGNED_INT, 0);
-                    }
-                }break;
-        case 2: CreateSphere(s_radius, s_sectorCount, s_stackCount);
-                if (!animation) {
-                    if ( m_radius1 == glm::vec3( 0.0f, 0.0f, 0.0f) ) {
-                        m_transform = m_projection * m_view * m_scale2;
-                        m_program->SetUniform("transform", m_transform);
-                        glDrawElements(GL_TRIANGLES, m_sphereIndexCount, GL_UNSIGNED_INT, 0);
-                    }
-                    else {
-                        auto model = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), m_radius1);
-                        m_transform = m_projection * m_view * m_scale2 * model;
-                        m_program->SetUniform("transform", m_transform);
-                        glDrawElements(GL_TRIANGLES, m_sphereIndexCount, GL_UNSIGNED_INT, 0);
-                    }
-                }
-                else {
-                    if (m_rotation == glm::vec3( 0.0f, 0.0f, 0.0f) && m_radius1 == glm::vec3( 0.0f, 0.0f, 0.0f)) {
-                            m_transform = m_projection * m_view * m_scale2;
-                            m_program->SetUniform("transform", m_transform);
-                            glDrawElements(GL_TRIANGLES, m_sphereIndexCount, GL_UNSIGNED_INT, 0);
-                    }
-                    else if ( m_rotation == glm::vec3( 0.0f, 0.0f, 0.0f) && m_radius1 != glm::vec3( 0.0f, 0.0f, 0.0f)) {
-                            auto model = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), m_radius1);
-                            m_transform = m_projection * m_view * m_scale2 * model;
-                            m_program->SetUniform("transform", m_transform);
-                            glDrawElements(GL_TRIANGLES, m_sphereIndexCount, GL_UNSIGNED_INT, 0);
-                    }
-                    else {
-                        auto model = glm::rotate(glm::mat4(1.0f), glm::radians((float)glfwGetTime() * 120.0f), m_rotation);
-                        m_transform = m_projection * m_view * m_scale2 * model;
-                        m_program->SetUniform("transform", m_transform);
-                        glDrawElements(GL_TRIANGLES, m_sphereIndexCount, GL_UNSIGNED_INT, 0);
-                    }
-                }break;
-    }
-}
-
-//box
-void Context::CreateBox() {
-    float vertices[] = {
-        -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,
-         0.5f, -0.5f, -0.5f, 1.0f, 0.0f,
-         0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
-        -0.5f,  0.5f, -0.5f, 0.0f, 1.0f,
-
-        -0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
-         0.5f, -0.5f,  0.5f, 1.0f, 0.0f,
-         0.5f,  0.5f,  0.5f, 1.0f, 1.0f,
-        -0.5f,  0.5f,  0.5f, 0.0f, 1.0f,
-
-        -0.5f,  0.5f,  0.5f, 1.0f, 0.0f,
-        -0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
-        -0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
-        -0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
-
-         0.5f,  0.5f,  0.5f, 1.0f, 0.0f,
-         0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
-         0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
-         0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
-
-        -0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
-         0.5f, -0.5f, -0.5f, 1.0f, 1.0f,
-         0.5f, -0.5f,  0.5f, 1.0f, 0.0f,
-        -0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
-
-        -0.5f,  0.5f, -0.5f, 0.0f, 1.0f,
-         0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
-         0.5f,  0.5f,  0.5f, 1.0f, 0.0f,
-        -0.5f,  0.5f,  0.5f, 0.0f, 0.0f,
-    };
-
-    uint32_t indices[] = {
-        0,  2,  1,  2,  0,  3,
-        4,  5,  6,  6,  7,  4,
-        8,  9, 10, 10, 11,  8,
-        12, 14, 13, 14, 12, 15,
-        16, 17, 18, 18, 19, 16,
-        20, 22, 21, 22, 20, 23,
-    };
-
-    m_boxVerticesCount = 24;
-    m_boxTrianglesCount = sizeof(indices)/12;
-    m_vertexLayout = VertexLayout::Create();
-    m_vertexBuffer = Buffer::CreateWithData(GL_ARRAY_BUFFER, GL_STATIC_DRAW, vertices, sizeof(float) * 120);
-
-    m_vertexLayout->SetAttrib(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 5, 0);
-    m_vertexLayout->SetAttrib(2, 2, GL_FLOAT, GL_FALSE, sizeof(float) * 5, sizeof(float) * 3);
-
-    m_indexBuffer = Buffer::CreateWithData(GL_ELEMENT_ARRAY_BUFFER, GL_STATIC_DRAW, indices, sizeof(uint32_t) * 36);
-}
-
-//cylinder
-void Context::CreateCylinder(float upperRadius, float lowerRadius, int segment, float height) {
-    std::vector<float> vertices;
-    std::vector<uint32_t> indices;
-
-    //z축 -인 원
-    vertices.push_back(0.0f);
-    vertices.push_back(-height/2);
-    vertices.push_back(0.0f);
-    for (int i = 0; i < segment ; i++) {
-        float angle = (360.0f / segment * i) * pi / 180.0f;
-        float x = cosf(angle) * lowerRadius;
-        float z = sinf(angle) * lowerRadius;
-        vertices.push_back(x);
-        vertices.push_back(-height/2);
-        vertices.push_back(z);
-    }
-    //z축 +인 원
-    vertices.push_back(0.0f);
-    vertices.push_back(height/2);
-    vertices.push_back(0.0f);
-    for (int i = 0; i < segment ; i++) {
-        float angle = (360.0f / segment * i) * pi / 180.0f;
-        float x = cosf(angle) * upperRadius;
-        float z = sinf(angle) * upperRadius;
-        vertices.push_back(x);
-        vertices.push_back(height/2);
-        vertices.push_back(z);
-    }
-    //z축 -인 원
-    for (int i = 0; i < segment; i++) {
-        indices.push_back(0);
-        indices.push_back(i + 1);
-        if ( i == segment - 1)
-            indices.push_back(1);
-        else
-            indices.push_back(i + 2);
-    }
-    //z축 +인 원
-    for (int i = segment; i < segment * 2 + 1; i++) {
-        indices.push_back(segment + 1);
-        indices.push_back(i + 1);
-        if ( i == segment * 2)
-            indices.push_back(segment + 2);
-        else
-            indices.push_back(i + 2);
+    //애니메이션 적용
+    glm::mat4 model { glm::mat4(1.0f) };
+    if (animation && m_rotation != glm::vec3(0.0f, 0.0f, 0.0f))
+        model = glm::rotate(glm::mat4(1.0f), glm::radians((float)glfwGetTime() * 120.0f), m_rotation);
+    else if (m_radius1 != glm::vec3(0.0f, 0.0f, 0.0f))
+        model = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), m_radius1);
+
+    if (scene_mode) {
+        //장면 전체를 draw call 하나로 (정점은 이미 world space)
+        if (scene_object_count != m_sceneObjectCount)
+            BuildScene(scene_object_count);
+        if (m_sceneBatch) {
+            program->SetUniform(kModelUniform, m_scale2 * model);
+            m_drawTimer->Begin();
+            m_sceneBatch->Draw();
+            m_drawTimer->End();
+        }
     }
-    //원 사이를 채움
-    for (int i = 1; i < segment; i++) {
-        indices.push_back(i);
-        indices.push_back(i + 1);
-        indices.push_back(i + segment + 1);
-
-        indices.push_back(i + segment + 1);
-        indices.push_back(i + segment + 2);
-        indices.push_back(i + 1);
+    else if (procedural) {
+        program->SetUniform(kModelUniform, m_scale2 * model);
+        m_drawTimer->Begin();
+        m_proceduralMesh->Draw(program, key);
+        m_drawTimer->End();
     }
-    indices.push_back(1);
-    indices.push_back(segment);
-    indices.push_back(segment * 2 + 1);
-    
-    indices.push_back(1);
-    indices.push_back(segment + 2);
-    indices.push_back(segment * 2 + 1);
-
-
-    m_cylinderVerticesCount = (segment + 1) * 3;
-    m_ctylinderTrianglesCount = segment * 4;
-    m_vertexLayout = VertexLayout::Create();
-    m_vertexBuffer = Buffer::CreateWithData(GL_ARRAY_BUFFER,
-        GL_STATIC_DRAW, vertices.data(), sizeof(float) * vertices.size());
-    
-    m_vertexLayout->SetAttrib(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, 0);
-
-    m_indexBuffer = Buffer::CreateWithData(GL_ELEMENT_ARRAY_BUFFER,
-        GL_STATIC_DRAW, indices.data(), sizeof(uint32_t) * indices.size());
-
-    m_clyinderIndexCount = (int)indices.size();
-}
-
-//sphere
-void Context::CreateSphere(float radius, int sectorCount, int stackCount) {
-    std::vector<float> vertices;
-    std::vector<float> normals;
-    std::vector<float> texCoords;
-    std::vector<uint32_t> indices;
-
-    float x = 0, y = 0, z = 0, xy = 0;
-    float nx = 0, ny = 0, nz = 0, lengthInv = 1.0f / radius;
-    float s = 0, t = 0;
-    int k1 = 0, k2 = 0;
-
-    float sectorStep = 2 * pi / s_sectorCount;
-    float stackStep = pi / s_stackCount;
-    float sectorAngle, stackAngle;
-
-    for(int i = 0; i <= s_stackCount; ++i) {
-        stackAngle = pi / 2 - i * stackStep;
-        xy = radius * cosf(stackAngle);
-        z = radius * sinf(stackAngle);
-
-        for(int j = 0; j <= s_sectorCount; ++j) {
-            sectorAngle = j * sectorStep;
-
-            x = xy * cosf(sectorAngle);
-            y = xy * sinf(sectorAngle);
-            vertices.push_back(x);
-            vertices.push_back(y);
-            vertices.push_back(z);
-
-            nx = x * lengthInv;
-            ny = y * lengthInv;
-            nz = z * lengthInv;
-            normals.push_back(nx);
-            normals.push_back(ny);
-            normals.push_back(nz);
-
-            s = (float)j / s_sectorCount;
-            t = (float)i / s_stackCount;
-            texCoords.push_back(s);
-            texCoords.push_back(t);
+    else if (instanced) {
+        program->SetUniform(kModelUniform, m_scale2 * model * mesh->GetDequantizeTransform());
+        //움직이는 instance는 매 프레임 stream buffer에 새로 씀
+        size_t offset = 0;
+        InstanceData* streamed = nullptr;
+        if (animate_instances) {
+            m_instanceStream->BeginFrame();
+            streamed = (InstanceData*)m_instanceStream->Allocate(
+                sizeof(InstanceData) * instance_count, sizeof(InstanceData), &offset);
+            if (streamed)
+                FillInstanceGrid(streamed, instance_count, (float)glfwGetTime());
+            m_instanceStream->FinishWrites();
         }
-    }
-
-    for(int i = 0; i < s_stackCount; ++i) {
-        k1 = i * (s_sectorCount + 1);
-        k2 = k1 + s_sectorCount + 1;
-
-        for(int j = 0; j < s_sectorCount; ++j, ++k1, ++k2) {
-            if(i != 0) {
-                indices.push_back(k1);
-                indices.push_back(k2);
-                indices.push_back(k1 + 1);
-            }
-            if(i != (s_stackCount-1)) {
-                indices.push_back(k1 + 1);
-                indices.push_back(k2);
-                indices.push_back(k2 + 1);
-            }
+        m_drawTimer->Begin();
+        if (streamed) {
+            mesh->DrawInstanced(m_instanceStream->GetBuffer(), instance_count, offset);
         }
-    }
-    m_sphereVerticesCount = ((2 * sectorCount - 1) * 2 * stackCount)/4;
-    m_sphereTrianglesCount = (2 * sectorCount - 1) * stackCount + 2;
-    m_vertexLayout = VertexLayout::Create();
-    m_vertexBuffer = Buffer::CreateWithData(GL_ARRAY_BUFFER,
-        GL_STATIC_DRAW, vertices.data(), sizeof(float) * vertices.size());
-    
-    m_vertexLayout->SetAttrib(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, 0);
-
-    m_indexBuffer = Buffer::CreateWithData(GL_ELEMENT_ARRAY_BUFFER,
-        GL_STATIC_DRAW, indices.data(), sizeof(uint32_t) * indices.size());
-
-    m_sphereIndexCount = (int)indices.size();
-}
-//torus
-void Context::CreateDonut(float ringRadius = 0.07, float tubeRadius = 0.15,
-            int rsegment = 16, int csegment = 8, int texture = 0) {
-    glFrontFace(GL_CW);
-
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-
-    const float TAU = 2 * pi;
-
-    for (int i = 0; i < rsegment; i++) {
-        glBegin(GL_QUAD_STRIP);
-        for (int j = 0; j <= csegment; j++) {
-            for (int k = 0; k <= 1; k++) {
-                double s = (i + k) % rsegment + 0.5;
-                double t = j % (csegment + 1);
-
-                double x = (tubeRadius + ringRadius * cos(s * TAU / rsegment)) * cos(t * TAU / csegment);
-                double y = (tubeRadius + ringRadius * cos(s * TAU / rsegment)) * sin(t * TAU / csegment);
-                double z = ringRadius * sin(s * TAU / rsegment);
-
-                double u = (i + k) / (float) rsegment;
-                double v = t / (float) csegment;
-
-                glTexCoord2d(u, v);
-                glNormal3f(2 * x, 2 * y, 2 * z);
-                glVertex3d(2 * x, 2 * y, 2 * z);
-            }
+        else {
+            if (instance_count != m_instanceCount)
+                BuildInstanceGrid(instance_count);
+            mesh->DrawInstanced(m_instanceBuffer.get(), m_instanceCount);
         }
-        glEnd();
+        m_drawTimer->End();
+        if (animate_instances)
+            m_instanceStream->EndFrame();
     }
-
-//  glFrontFace(GL_CCW);
-}
\ No newline at end of file
+    else if (mesh) {
+        program->SetUniform(kModelUniform, m_scale2 * model * mesh->GetDequantizeTransform());
+        m_drawTimer->Begin();
+        mesh->Draw();
+        m_drawTimer->End();
+    }
+    if (srgbOutput)
+        glDisable(GL_FRAMEBUFFER_SRGB);
+}
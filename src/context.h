@@ -4,18 +4,26 @@
 #include "common.h"
 #include "shader.h"
 #include "program.h"
+#include "program_cache.h"
+#include "program_batch.h"
+#include "program_variants.h"
+#include "shader_watcher.h"
 #include "buffer.h"
 #include "vertex_layout.h"
 #include "texture.h"
+#include "texture_loader.h"
+#include "texture_atlas.h"
+#include "mesh_cache.h"
+#include "gpu_timer.h"
+#include "procedural_mesh.h"
+#include "mesh_batch.h"
+#include "stream_buffer.h"
+#include "uniform_buffer.h"
 
 CLASS_PTR(Context)
 class Context {
 public:
     static ContextUPtr Create();
-    void CreateBox();
-    void CreateCylinder(float upperRadius, float lowerRadius, int segment, float height);
-    void CreateSphere(float radius, int sectorCount, int stackCount);
-    void CreateDonut(float ringRadius, float tubeRadius, int rsegment, int csegment, int texture);
     void Render();    
     void ProcessInput(GLFWwindow* window);
     void Reshape(int width, int height);
@@ -25,18 +33,65 @@ public:
 private:
     Context() {}
     bool Init();
-    ProgramUPtr m_program;
+    // 모든 program이 공유하는 프레임 단위 uniform (shader의 FrameData block)
+    struct FrameDataLayout {
+        size_t view;
+        size_t projection;
+        size_t viewProjection;
+        size_t viewport;
+        size_t time;
+        size_t srgbOutput;
+    };
+    FrameDataLayout m_frameDataLayout;
+    UniformBufferUPtr m_frameData;
 
-    VertexLayoutUPtr m_vertexLayout;
-    BufferUPtr m_vertexBuffer;
-    BufferUPtr m_indexBuffer;
-    int m_clyinderIndexCount {6};
-    int m_sphereIndexCount {6};
+    ProgramCacheUPtr m_programCache;
+    // 백그라운드 컴파일, 준비 전에는 기본 program(기능 없는 texture variant) 사용
+    ProgramBatchUPtr m_programBatch;
+    ProgramVariantsUPtr m_textureVariants;
+    ProgramVariantsUPtr m_proceduralVariants;
+    size_t m_instancedSlot { 0 };
+    // shader 디렉터리 감시 (inotify가 없으면 nullptr)
+    ShaderWatcherUPtr m_shaderWatcher;
 
+    // 정적 geometry용 큰 버퍼들 (mesh cache와 batch보다 먼저 선언해서 나중에 해제)
+    BufferHeapUPtr m_vertexHeap;
+    BufferHeapUPtr m_indexHeap;
+
+    // 파라미터가 바뀔 때만 도형을 다시 생성
+    MeshCacheUPtr m_meshCache;
+    // 삼각형 리스트와 strip 비교용 draw 시간
+    GpuTimerUPtr m_drawTimer;
+    // 버퍼 없이 shader에서 정점을 만드는 모드
+    ProceduralMeshUPtr m_proceduralMesh;
+
+    // instancing stress mode: 같은 도형 N개를 draw call 하나로
+    // 버퍼는 최대 크기로 한 번만 만들고 개수가 바뀔 때 내용만 갱신
+    static const int kMaxInstances = 100000;
+    void FillInstanceGrid(InstanceData* out, int count, float time) const;
+    void BuildInstanceGrid(int count);
+    BufferUPtr m_instanceBuffer;
+    int m_instanceCount { 0 };
+    // 매 프레임 움직이는 instance 데이터 (3 프레임 ring)
+    StreamBufferUPtr m_instanceStream;
+
+    // 여러 종류의 도형을 섞은 정적 장면: 버퍼 하나, multi draw 한 번
+    void BuildScene(int count);
+    MeshBatchUPtr m_sceneBatch;
+    int m_sceneObjectCount { 0 };
+
+    // 이미지 디코딩은 worker thread에서
+    TextureLoaderUPtr m_textureLoader;
     //텍스처가 총 3개이기 때문에 변수 추가
-    TextureUPtr m_texture0;
-    TextureUPtr m_texture1;
-    TextureUPtr m_texture2;
+    TexturePtr m_texture0;
+    TexturePtr m_texture1;
+    TexturePtr m_texture2;
+    // 세 텍스처를 한 장에 모은 atlas: 물체마다 uv 영역만 바꾸고 bind는 한 번.
+    // 처음 켤 때 이미지를 비동기로 읽고 모두 준비되면 생성
+    void UpdateAtlas();
+    TextureAtlasUPtr m_atlas;
+    std::vector<std::future<ImageUPtr>> m_atlasImages;
+    bool m_atlasFailed { false };
 
     // clear color
     glm::vec4 m_clearColor { glm::vec4(0.5f, 0.5f, 0.5f, 0.0f) };
@@ -66,18 +121,7 @@ private:
                 m_cameraPos,
                 m_cameraPos + m_cameraFront,
                 m_cameraUp);
-    glm::mat4 m_transform;
-
-    const float pi = 3.141592f;
-
 
-    //vertices count, triangles count
-    int m_boxVerticesCount;
-    int m_boxTrianglesCount;
-    int m_cylinderVerticesCount;
-    int m_ctylinderTrianglesCount;
-    int m_sphereVerticesCount;
-    int m_sphereTrianglesCount;
     //cylinder mem
     float c_upperRadius = 0.5f;
     float c_lowerRadius = 0.5f;
@@ -87,6 +131,11 @@ private:
     float s_radius = 0.5f;
     int s_sectorCount = 32;
     int s_stackCount = 16;
+    //donut mem
+    float d_ringRadius = 0.3f;
+    float d_tubeRadius = 0.15f;
+    int d_ringSegment = 32;
+    int d_tubeSegment = 16;
 };
 
 #endif // __CONTEXT_H__
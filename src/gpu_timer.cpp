@@ -0,0 +1,49 @@
+#include "gpu_timer.h"
+
+GpuTimerUPtr GpuTimer::Create() {
+    auto timer = GpuTimerUPtr(new GpuTimer());
+    timer->Init();
+    return std::move(timer);
+}
+
+GpuTimer::~GpuTimer() {
+    if (m_queries[0])
+        glDeleteQueries((GLsizei)kQueryCount, m_queries.data());
+}
+
+void GpuTimer::Init() {
+    glGenQueries((GLsizei)kQueryCount, m_queries.data());
+}
+
+void GpuTimer::Begin() {
+    Collect();
+    // every query still in flight: skip this measurement rather than wait
+    if (m_pending[m_current])
+        return;
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_current]);
+    m_running = true;
+}
+
+void GpuTimer::End() {
+    if (!m_running)
+        return;
+    glEndQuery(GL_TIME_ELAPSED);
+    m_running = false;
+    m_pending[m_current] = true;
+    m_current = (m_current + 1) % kQueryCount;
+}
+
+void GpuTimer::Collect() {
+    for (size_t i = 0; i < kQueryCount; i++) {
+        if (!m_pending[i])
+            continue;
+        GLint available = 0;
+        glGetQueryObjectiv(m_queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(m_queries[i], GL_QUERY_RESULT, &elapsed);
+        m_pending[i] = false;
+        m_elapsedMs = m_elapsedMs * 0.9f + (float)(elapsed * 1e-6) * 0.1f;
+    }
+}
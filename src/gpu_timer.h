@@ -0,0 +1,33 @@
+#ifndef __GPU_TIMER_H__
+#define __GPU_TIMER_H__
+
+#include "common.h"
+#include <array>
+
+// GL_TIME_ELAPSED queries in a small ring so reading a result never stalls
+// the pipeline: the reported time is from a frame or two ago
+CLASS_PTR(GpuTimer)
+class GpuTimer {
+public:
+    static GpuTimerUPtr Create();
+    ~GpuTimer();
+
+    void Begin();
+    void End();
+    // last finished measurement, smoothed over a few frames
+    float GetElapsedMs() const { return m_elapsedMs; }
+
+private:
+    GpuTimer() {}
+    void Init();
+    void Collect();
+
+    static const size_t kQueryCount = 4;
+    std::array<uint32_t, kQueryCount> m_queries {};
+    std::array<bool, kQueryCount> m_pending {};
+    size_t m_current { 0 };
+    bool m_running { false };
+    float m_elapsedMs { 0.0f };
+};
+
+#endif // __GPU_TIMER_H__
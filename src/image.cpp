@@ -1,4 +1,5 @@
 #include "image.h"
+#include "image_kernels.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 
@@ -32,12 +33,36 @@ Image::~Image() {
 }
 
 bool Image::LoadWithStb(const std::string& filepath) {
-    stbi_set_flip_vertically_on_load(true);
+    // stb의 flip은 한 행씩 복사하므로 디코딩 후 kernel로 뒤집음.
+    // worker thread에서 동시에 불릴 수 있으므로 전역 설정 대신 스레드별 설정
+    stbi_set_flip_vertically_on_load_thread(false);
     m_data = stbi_load(filepath.c_str(), &m_width, &m_height, &m_channelCount, 0);
     if (!m_data) {
         SPDLOG_ERROR("failed to load image: {}", filepath);
         return false;
     }
+    FlipVertical();
+    // RGB는 GPU에서 어차피 4 채널로 저장되므로 미리 확장해서 드라이버 변환을 피함
+    return ExpandToRGBA();
+}
+
+void Image::FlipVertical() {
+    ::FlipVertical(m_data, (size_t)m_width * m_channelCount, m_height);
+}
+
+bool Image::ExpandToRGBA() {
+    if (m_channelCount != 3)
+        return true;
+    size_t pixelCount = (size_t)m_width * m_height;
+    auto data = (uint8_t*)malloc(pixelCount * 4);
+    if (!data) {
+        SPDLOG_ERROR("failed to allocate {}x{} RGBA image", m_width, m_height);
+        return false;
+    }
+    ExpandRGBToRGBA(m_data, data, pixelCount);
+    stbi_image_free(m_data);
+    m_data = data;
+    m_channelCount = 4;
     return true;
 }
 
@@ -50,7 +75,7 @@ void Image::SetCheckImage(int gridX, int gridY) {
             for (int k = 0; k < m_channelCount; k++)
                 m_data[pos + k] = value;
             if (m_channelCount > 3)
-                m_data[3] = 255;
+                m_data[pos + 3] = 255;
         }
     }
 }
\ No newline at end of file
@@ -16,6 +16,10 @@ public:
     int GetChannelCount() const { return m_channelCount; }
 
     void SetCheckImage(int gridX, int gridY);
+    // reverses the row order (GL expects the bottom row first)
+    void FlipVertical();
+    // RGB -> RGBA with opaque alpha; other channel counts are left as is
+    bool ExpandToRGBA();
 
 private:
     Image() {};
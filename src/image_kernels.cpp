@@ -0,0 +1,358 @@
+#include "image_kernels.h"
+#include "worker_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define IMAGE_USE_AVX2 1
+#endif
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define IMAGE_USE_SSSE3 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define IMAGE_USE_SSE2 1
+#endif
+
+// rows (or pixels) per task: small images stay on the calling thread
+static const size_t kBytesPerTask = 256 * 1024;
+
+static int GetGrain(size_t bytesPerItem) {
+    return (int)std::max<size_t>(1, kBytesPerTask / std::max<size_t>(1, bytesPerItem));
+}
+
+int GetMipLevelCount(int width, int height) {
+    int count = 1;
+    for (int size = std::max(width, height); size > 1; size /= 2)
+        count++;
+    return count;
+}
+
+const char* GetImageKernelSimdPath() {
+#if IMAGE_USE_AVX2
+    return "avx2";
+#elif IMAGE_USE_SSSE3
+    return "ssse3";
+#elif IMAGE_USE_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+// RGB -> RGBA
+
+static void ExpandRGBToRGBARange(const uint8_t* src, uint8_t* dst, size_t begin, size_t end) {
+    size_t i = begin;
+#if IMAGE_USE_AVX2
+    // 8 pixels: 24 bytes를 두 lane에 12 bytes씩 나눈 뒤 lane 안에서 shuffle.
+    // 32 bytes를 읽으므로 끝에서 8 bytes 이상 남아 있을 때만
+    const __m256i spread = _mm256_setr_epi32(0, 1, 2, 0, 3, 4, 5, 0);
+    const __m256i shuffle8 = _mm256_setr_epi8(
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m256i alpha8 = _mm256_set1_epi32((int)0xFF000000);
+    for (; i + 11 <= end; i += 8) {
+        __m256i rgb = _mm256_loadu_si256((const __m256i*)(src + i * 3));
+        rgb = _mm256_permutevar8x32_epi32(rgb, spread);
+        __m256i rgba = _mm256_or_si256(_mm256_shuffle_epi8(rgb, shuffle8), alpha8);
+        _mm256_storeu_si256((__m256i*)(dst + i * 4), rgba);
+    }
+#endif
+#if IMAGE_USE_SSSE3
+    const __m128i shuffle4 = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha4 = _mm_set1_epi32((int)0xFF000000);
+    for (; i + 6 <= end; i += 4) {
+        __m128i rgb = _mm_loadu_si128((const __m128i*)(src + i * 3));
+        __m128i rgba = _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle4), alpha4);
+        _mm_storeu_si128((__m128i*)(dst + i * 4), rgba);
+    }
+#endif
+    for (; i < end; i++) {
+        dst[i * 4 + 0] = src[i * 3 + 0];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + 2];
+        dst[i * 4 + 3] = 255;
+    }
+}
+
+void ExpandRGBToRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount) {
+    // 청크 경계에서도 SIMD 경로가 청크 밖을 읽지 않도록 end 기준으로 검사함
+    int grain = GetGrain(4);
+    int chunkCount = (int)((pixelCount + grain - 1) / grain);
+    WorkerPool::Shared().ParallelFor(chunkCount, 1, [&](int begin, int end) {
+        for (int chunk = begin; chunk < end; chunk++) {
+            size_t first = (size_t)chunk * grain;
+            ExpandRGBToRGBARange(src, dst, first, std::min(pixelCount, first + grain));
+        }
+    });
+}
+
+// flip
+
+void FlipVertical(uint8_t* data, size_t rowBytes, int height) {
+    WorkerPool::Shared().ParallelFor(height / 2, GetGrain(rowBytes * 2), [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            uint8_t* top = data + rowBytes * y;
+            uint8_t* bottom = data + rowBytes * (height - 1 - y);
+            std::swap_ranges(top, top + rowBytes, bottom);
+        }
+    });
+}
+
+// box
+
+static void DownsampleBoxRow(const uint8_t* row0, const uint8_t* row1, int width,
+    int channelCount, int dstWidth, uint8_t* out) {
+    int x = 0;
+#if IMAGE_USE_SSE2
+    if (channelCount == 4 && width >= 2) {
+        // 입력 4 픽셀(16 bytes) x 2행 -> 출력 2 픽셀, 16bit로 넓혀서 정확히 반올림
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i round = _mm_set1_epi16(2);
+        for (; x + 2 <= dstWidth; x += 2) {
+            __m128i a = _mm_loadu_si128((const __m128i*)(row0 + x * 8));
+            __m128i b = _mm_loadu_si128((const __m128i*)(row1 + x * 8));
+            __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+            __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+            lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+            hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+            __m128i sum = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(lo, hi), round), 2);
+            _mm_storel_epi64((__m128i*)(out + x * 4), _mm_packus_epi16(sum, sum));
+        }
+    }
+#endif
+    for (; x < dstWidth; x++) {
+        int x0 = std::min(x * 2, width - 1) * channelCount;
+        int x1 = std::min(x * 2 + 1, width - 1) * channelCount;
+        for (int c = 0; c < channelCount; c++) {
+            int sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+            out[x * channelCount + c] = (uint8_t)((sum + 2) / 4);
+        }
+    }
+}
+
+void DownsampleBox(const uint8_t* src, int width, int height, int channelCount, uint8_t* dst) {
+    int dstWidth = std::max(width / 2, 1);
+    int dstHeight = std::max(height / 2, 1);
+    size_t srcPitch = (size_t)width * channelCount;
+    size_t dstPitch = (size_t)dstWidth * channelCount;
+    WorkerPool::Shared().ParallelFor(dstHeight, GetGrain(srcPitch * 2), [&](int begin, int end) {
+        for (int y = begin; y < end; y++) {
+            const uint8_t* row0 = src + srcPitch * std::min(y * 2, height - 1);
+            const uint8_t* row1 = src + srcPitch * std::min(y * 2 + 1, height - 1);
+            DownsampleBoxRow(row0, row1, width, channelCount, dstWidth, dst + dstPitch * y);
+        }
+    });
+}
+
+// filtered / gamma-correct
+
+static const float* GetSrgbToLinearTable() {
+    static const std::vector<float> table = [] {
+        std::vector<float> values(256);
+        for (int i = 0; i < 256; i++) {
+            float c = i / 255.0f;
+            values[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+// linear [0, 1]을 4096 단계로 나눠 sRGB 8bit로 (8bit 출력에는 충분한 정밀도)
+static const int kLinearSteps = 4096;
+static const uint8_t* GetLinearToSrgbTable() {
+    static const std::vector<uint8_t> table = [] {
+        std::vector<uint8_t> values(kLinearSteps);
+        for (int i = 0; i < kLinearSteps; i++) {
+            float l = i / (float)(kLinearSteps - 1);
+            float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            values[i] = (uint8_t)std::lround(std::min(std::max(c, 0.0f), 1.0f) * 255.0f);
+        }
+        return values;
+    }();
+    return table.data();
+}
+
+// float [0, 1] 행을 8bit로. toSrgb가 있으면 color 채널은 sRGB로 인코딩
+static void EncodeRow(const float* values, uint8_t* out, int pixelCount, int channelCount,
+    int colorCount, const uint8_t* toSrgb) {
+    int x = 0;
+#if IMAGE_USE_SSE2
+    // Kaiser의 음수 lobe 때문에 범위를 벗어날 수 있으므로 clamp 후 반올림
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    if (!toSrgb) {
+        // 채널 구분이 없으므로 4 값씩
+        const __m128 scale = _mm_set1_ps(255.0f);
+        size_t count = (size_t)pixelCount * channelCount, i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(values + i), zero), one);
+            __m128i bytes = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half));
+            bytes = _mm_packus_epi16(_mm_packs_epi32(bytes, bytes), bytes);
+            int packed = _mm_cvtsi128_si32(bytes);
+            memcpy(out + i, &packed, 4);
+        }
+        for (; i < count; i++)
+            out[i] = (uint8_t)(std::min(std::max(values[i], 0.0f), 1.0f) * 255.0f + 0.5f);
+        return;
+    }
+    else if (channelCount == 4) {
+        // RGB는 LUT 인덱스(4096 단계), alpha는 그대로 255 단계
+        const __m128 scale = _mm_setr_ps(kLinearSteps - 1, kLinearSteps - 1, kLinearSteps - 1, 255.0f);
+        for (; x < pixelCount; x++) {
+            __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(values + x * 4), zero), one);
+            alignas(16) int32_t index[4];
+            _mm_store_si128((__m128i*)index,
+                _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half)));
+            out[x * 4 + 0] = toSrgb[index[0]];
+            out[x * 4 + 1] = toSrgb[index[1]];
+            out[x * 4 + 2] = toSrgb[index[2]];
+            out[x * 4 + 3] = (uint8_t)index[3];
+        }
+    }
+#endif
+    for (; x < pixelCount; x++) {
+        for (int c = 0; c < channelCount; c++) {
+            float value = std::min(std::max(values[x * channelCount + c], 0.0f), 1.0f);
+            out[x * channelCount + c] = toSrgb && c < colorCount ?
+                toSrgb[(int)(value * (kLinearSteps - 1) + 0.5f)] : (uint8_t)(value * 255.0f + 0.5f);
+        }
+    }
+}
+
+static double BesselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// 2배 축소용 separable filter: 출력 i는 입력 2i + first ... 2i + first + weights - 1
+struct DecimationFilter {
+    int first;
+    std::vector<float> weights;
+};
+
+static DecimationFilter MakeFilter(MipFilter filter) {
+    if (filter == MipFilter::Box)
+        return { 0, { 0.5f, 0.5f } };
+
+    // 출력 픽셀 중심은 입력 2i와 2i + 1 사이, 탭 거리 d = -3.5 ... 3.5
+    const int taps = 8;
+    const double alpha = 4.0, halfWidth = taps / 2.0, pi = 3.14159265358979323846;
+    DecimationFilter kaiser { -3, std::vector<float>(taps) };
+    double total = 0.0;
+    std::vector<double> weights(taps);
+    for (int i = 0; i < taps; i++) {
+        double d = i - 3.5;
+        double x = d * 0.5;  // 축소 비율만큼 sinc를 늘림
+        double sinc = std::sin(pi * x) / (pi * x);
+        double r = d / halfWidth;
+        double window = BesselI0(alpha * std::sqrt(std::max(0.0, 1.0 - r * r))) / BesselI0(alpha);
+        weights[i] = sinc * window;
+        total += weights[i];
+    }
+    for (int i = 0; i < taps; i++)
+        kaiser.weights[i] = (float)(weights[i] / total);
+    return kaiser;
+}
+
+void Downsample(const uint8_t* src, int width, int height, int channelCount, uint8_t* dst,
+    MipFilter filter, bool srgb) {
+    if (filter == MipFilter::Box && !srgb) {
+        DownsampleBox(src, width, height, channelCount, dst);
+        return;
+    }
+
+    int dstWidth = std::max(width / 2, 1);
+    int dstHeight = std::max(height / 2, 1);
+    // 2, 4 채널의 마지막 채널은 alpha (항상 linear)
+    int colorCount = channelCount == 2 || channelCount == 4 ? channelCount - 1 : channelCount;
+    const float* toLinear = GetSrgbToLinearTable();
+    const uint8_t* toSrgb = GetLinearToSrgbTable();
+    DecimationFilter kernel = MakeFilter(filter);
+    auto& pool = WorkerPool::Shared();
+
+    // 1. 가로 방향: width x height 바이트 -> dstWidth x height float.
+    // 한 행을 먼저 float로 풀고 양 끝을 clamp한 값으로 채워서 탭 루프에 분기가 없게 함
+    int taps = (int)kernel.weights.size();
+    int padLeft = -kernel.first;
+    int padRight = taps - 2 + kernel.first;
+    size_t tempPitch = (size_t)dstWidth * channelCount;
+    std::vector<float> temp(tempPitch * height);
+    pool.ParallelFor(height, GetGrain((size_t)width * channelCount * 4), [&](int begin, int end) {
+        std::vector<float> padded((size_t)(width + padLeft + padRight + 1) * channelCount);
+        for (int y = begin; y < end; y++) {
+            const uint8_t* row = src + (size_t)width * channelCount * y;
+            for (int x = -padLeft; x < width + padRight + 1; x++) {
+                int sx = std::min(std::max(x, 0), width - 1);
+                for (int c = 0; c < channelCount; c++) {
+                    uint8_t value = row[sx * channelCount + c];
+                    padded[(x + padLeft) * channelCount + c] =
+                        srgb && c < colorCount ? toLinear[value] : value * (1.0f / 255.0f);
+                }
+            }
+            float* out = temp.data() + tempPitch * y;
+            // 1픽셀 폭이면 그대로 복사 (모든 탭이 같은 픽셀이므로 가중치 합 1)
+            int step = width == 1 ? 0 : 2;
+            int x = 0;
+#if IMAGE_USE_SSE2
+            if (channelCount == 4) {
+                // RGBA 한 픽셀이 __m128 하나, 가중치는 broadcast
+                for (; x < dstWidth; x++) {
+                    const float* window = padded.data() + (size_t)x * step * 4;
+                    __m128 sum = _mm_setzero_ps();
+                    for (int t = 0; t < taps; t++)
+                        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_load1_ps(&kernel.weights[t]),
+                            _mm_loadu_ps(window + t * 4)));
+                    _mm_storeu_ps(out + x * 4, sum);
+                }
+            }
+#endif
+            for (; x < dstWidth; x++) {
+                const float* window = padded.data() + (size_t)x * step * channelCount;
+                for (int c = 0; c < channelCount; c++) {
+                    float sum = 0.0f;
+                    for (int t = 0; t < taps; t++)
+                        sum += kernel.weights[t] * window[t * channelCount + c];
+                    out[x * channelCount + c] = sum;
+                }
+            }
+        }
+    });
+
+    // 2. 세로 방향 후 다시 8bit로
+    pool.ParallelFor(dstHeight, GetGrain(tempPitch * 4 * taps), [&](int begin, int end) {
+        std::vector<float> sum(tempPitch);
+        for (int y = begin; y < end; y++) {
+            std::fill(sum.begin(), sum.end(), 0.0f);
+            for (int t = 0; t < taps; t++) {
+                int sy = height == 1 ? 0 : std::min(std::max(y * 2 + kernel.first + t, 0), height - 1);
+                const float* row = temp.data() + tempPitch * sy;
+                float weight = kernel.weights[t];
+                size_t i = 0;
+#if IMAGE_USE_SSE2
+                const __m128 weight4 = _mm_set1_ps(weight);
+                for (; i + 4 <= tempPitch; i += 4) {
+                    __m128 acc = _mm_loadu_ps(sum.data() + i);
+                    acc = _mm_add_ps(acc, _mm_mul_ps(weight4, _mm_loadu_ps(row + i)));
+                    _mm_storeu_ps(sum.data() + i, acc);
+                }
+#endif
+                for (; i < tempPitch; i++)
+                    sum[i] += weight * row[i];
+            }
+            EncodeRow(sum.data(), dst + tempPitch * y, dstWidth, channelCount, colorCount,
+                srgb ? toSrgb : nullptr);
+        }
+    });
+}
@@ -0,0 +1,37 @@
+#ifndef __IMAGE_KERNELS_H__
+#define __IMAGE_KERNELS_H__
+
+#include <cstddef>
+#include <cstdint>
+
+// CPU pixel kernels on 8-bit images without GL, shared by the texture
+// cooker and runtime loading. rows are tightly packed (width * channels).
+// the hot loops use SSSE3/AVX2 when compiled in and large images are
+// split across WorkerPool::Shared() by rows
+
+enum class MipFilter {
+    Box,     // 2x2 average
+    Kaiser,  // 8 tap Kaiser-windowed sinc per axis, sharper minification
+};
+
+// levels of a full mip chain down to 1x1
+int GetMipLevelCount(int width, int height);
+
+// 3 -> 4 channels with alpha 255. dst must not overlap src
+void ExpandRGBToRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount);
+// reverses the row order in place
+void FlipVertical(uint8_t* data, size_t rowBytes, int height);
+
+// one mip step: dst is max(width / 2, 1) x max(height / 2, 1) and each
+// pixel averages the 2x2 block above it (edges of odd sizes are clamped).
+// plain byte averaging, see Downsample for gamma-correct filtering
+void DownsampleBox(const uint8_t* src, int width, int height, int channelCount, uint8_t* dst);
+// one mip step with any filter. srgb: color channels are decoded to linear
+// light before filtering and encoded again after (alpha stays linear)
+void Downsample(const uint8_t* src, int width, int height, int channelCount, uint8_t* dst,
+    MipFilter filter, bool srgb);
+
+// name of the code path selected at compile time ("avx2", "ssse3", "sse2", "scalar")
+const char* GetImageKernelSimdPath();
+
+#endif // __IMAGE_KERNELS_H__
@@ -70,6 +70,8 @@ int main(int argc, const char** argv) {
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    // 장면은 sRGB 텍스처를 linear로 읽으므로 출력할 때 다시 sRGB로 인코딩
+    glfwWindowHint(GLFW_SRGB_CAPABLE, GL_TRUE);
 
         // glfw 윈도우 생성, 실패하면 에러 출력후 종료
     SPDLOG_INFO("Create glfw window");
@@ -0,0 +1,171 @@
+#include "mesh.h"
+#include "vertex_compression.h"
+
+// position(3) + normal(3) + texcoord(2)
+static const int kVertexFloatCount = 8;
+
+static void InterleaveVertices(const MeshData& data, float* out) {
+    size_t vertexCount = data.GetVertexCount();
+    for (size_t i = 0; i < vertexCount; i++, out += kVertexFloatCount) {
+        const float* p = &data.positions[i * 3];
+        const float* n = &data.normals[i * 3];
+        const float* uv = &data.texCoords[i * 2];
+        out[0] = p[0]; out[1] = p[1]; out[2] = p[2];
+        out[3] = n[0]; out[4] = n[1]; out[5] = n[2];
+        out[6] = uv[0]; out[7] = uv[1];
+    }
+}
+
+MeshUPtr Mesh::Create(const MeshData& data, BufferHeap* vertexHeap, BufferHeap* indexHeap,
+    VertexFormat format, const IndexBinding* indices) {
+    auto mesh = MeshUPtr(new Mesh());
+    if (!mesh->Init(data, vertexHeap, indexHeap, format, indices))
+        return nullptr;
+    return std::move(mesh);
+}
+
+size_t Mesh::GetVertexSize() const {
+    return m_format == VertexFormat::Compact ?
+        sizeof(CompactVertex) : sizeof(float) * kVertexFloatCount;
+}
+
+void Mesh::WriteVertices(const MeshData& data, void* out) {
+    if (m_format == VertexFormat::Float) {
+        InterleaveVertices(data, (float*)out);
+        return;
+    }
+
+    auto quantization = ComputePositionQuantization(data);
+    CompressVertices(data, quantization, (CompactVertex*)out);
+    m_dequantize =
+        glm::translate(glm::mat4(1.0f), glm::make_vec3(quantization.center)) *
+        glm::scale(glm::mat4(1.0f), glm::make_vec3(quantization.halfExtent));
+}
+
+bool Mesh::UpdateVertices(const MeshData& data) {
+    if ((int)data.GetVertexCount() != m_vertexCount) {
+        SPDLOG_ERROR("vertex count mismatch: {} != {}", data.GetVertexCount(), m_vertexCount);
+        return false;
+    }
+
+    // heap buffer은 다른 mesh와 공유하므로 자기 영역만 invalidate
+    auto& buffer = m_vertices->buffer;
+    size_t size = m_vertices->size;
+    auto mapped = buffer->Map(m_vertices->offset, size,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    if (mapped) {
+        WriteVertices(data, mapped);
+        if (buffer->Unmap())
+            return true;
+    }
+
+    std::vector<uint8_t> vertices(size);
+    WriteVertices(data, vertices.data());
+    buffer->UpdateData(vertices.data(), size, m_vertices->offset);
+    return true;
+}
+
+void Mesh::Draw() const {
+    m_vertexLayout->Bind();
+    DrawElements(1);
+}
+
+void Mesh::DrawInstanced(const Buffer* instances, int instanceCount, size_t offset) const {
+    m_vertexLayout->Bind();
+    // 버퍼나 위치가 바뀔 때만 VAO에 instance attribute를 다시 연결
+    if (m_instanceBuffer != instances->Get() || m_instanceOffset != offset) {
+        instances->Bind();
+        const size_t stride = sizeof(InstanceData);
+        for (uint32_t column = 0; column < 4; column++) {
+            m_vertexLayout->SetAttrib(3 + column, 4, GL_FLOAT, GL_FALSE, stride,
+                offset + offsetof(InstanceData, model) + sizeof(glm::vec4) * column);
+            m_vertexLayout->SetAttribDivisor(3 + column, 1);
+        }
+        m_vertexLayout->SetAttrib(7, 4, GL_FLOAT, GL_FALSE, stride,
+            offset + offsetof(InstanceData, color));
+        m_vertexLayout->SetAttribDivisor(7, 1);
+        m_instanceBuffer = instances->Get();
+        m_instanceOffset = offset;
+    }
+    DrawElements(instanceCount);
+}
+
+void Mesh::DrawElements(int instanceCount) const {
+    bool strips = m_indices.mode != GL_TRIANGLES;
+    // strip 사이의 restart 인덱스는 인덱스 타입의 최댓값
+    // 4.3 / ES3 호환이면 fixed index, 아니면 3.1의 glPrimitiveRestartIndex
+    bool fixedIndex = GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_ES3_compatibility;
+    if (strips && fixedIndex) {
+        glEnable(GL_PRIMITIVE_RESTART_FIXED_INDEX);
+    }
+    else if (strips) {
+        glEnable(GL_PRIMITIVE_RESTART);
+        glPrimitiveRestartIndex(m_indices.type == GL_UNSIGNED_SHORT ? 0xFFFF : kPrimitiveRestartIndex);
+    }
+
+    // 인덱스는 heap buffer 안의 offset부터 (정점 offset은 attribute에 들어 있음)
+    auto first = (const void*)m_indices.allocation->offset;
+    if (instanceCount == 1)
+        glDrawElements(m_indices.mode, m_indices.count, m_indices.type, first);
+    else
+        glDrawElementsInstanced(m_indices.mode, m_indices.count, m_indices.type, first, instanceCount);
+
+    if (strips)
+        glDisable(fixedIndex ? GL_PRIMITIVE_RESTART_FIXED_INDEX : GL_PRIMITIVE_RESTART);
+}
+
+bool Mesh::Init(const MeshData& data, BufferHeap* vertexHeap, BufferHeap* indexHeap,
+    VertexFormat format, const IndexBinding* indices) {
+    m_format = format;
+    m_vertexCount = (int)data.GetVertexCount();
+
+    size_t stride = GetVertexSize();
+    std::vector<uint8_t> vertices(stride * m_vertexCount);
+    WriteVertices(data, vertices.data());
+    m_vertices = vertexHeap->AllocateShared(vertices.data(), vertices.size());
+    if (!m_vertices)
+        return false;
+
+    if (indices) {
+        // 같은 topology의 인덱스 영역을 공유
+        m_indices = *indices;
+    }
+    else {
+        m_indices.type = format == VertexFormat::Compact && CanUse16BitIndices(m_vertexCount) ?
+            GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        m_indices.mode = data.topology == PrimitiveTopology::TriangleStrip ?
+            GL_TRIANGLE_STRIP : GL_TRIANGLES;
+        m_indices.count = (int)data.indices.size();
+        m_indices.triangleCount = (int)data.GetTriangleCount();
+        if (m_indices.type == GL_UNSIGNED_SHORT) {
+            std::vector<uint16_t> compressed(data.indices.size());
+            CompressIndices(data.indices.data(), data.indices.size(), compressed.data());
+            m_indices.allocation = indexHeap->AllocateShared(compressed.data(),
+                sizeof(uint16_t) * compressed.size());
+        }
+        else {
+            m_indices.allocation = indexHeap->AllocateShared(data.indices.data(),
+                sizeof(uint32_t) * data.indices.size());
+        }
+        if (!m_indices.allocation)
+            return false;
+    }
+
+    // index heap에 쓰는 동안 VAO가 풀리므로 할당이 끝난 뒤에 VAO를 만듦
+    m_vertexLayout = VertexLayout::Create();
+    m_vertices->buffer->Bind();
+    size_t base = m_vertices->offset;
+    if (m_format == VertexFormat::Compact) {
+        // snorm 위치는 bounds 기준 [-1, 1], 법선은 2_10_10_10, uv는 half float
+        m_vertexLayout->SetAttrib(0, 3, GL_SHORT, GL_TRUE, stride, base + offsetof(CompactVertex, position));
+        m_vertexLayout->SetAttrib(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, base + offsetof(CompactVertex, normal));
+        m_vertexLayout->SetAttrib(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, base + offsetof(CompactVertex, texCoord));
+    }
+    else {
+        m_vertexLayout->SetAttrib(0, 3, GL_FLOAT, GL_FALSE, stride, base);
+        m_vertexLayout->SetAttrib(1, 3, GL_FLOAT, GL_FALSE, stride, base + sizeof(float) * 3);
+        m_vertexLayout->SetAttrib(2, 2, GL_FLOAT, GL_FALSE, stride, base + sizeof(float) * 6);
+    }
+    m_indices.allocation->buffer->Bind();
+    return true;
+}
@@ -0,0 +1,82 @@
+#ifndef __MESH_H__
+#define __MESH_H__
+
+#include "common.h"
+#include "buffer.h"
+#include "buffer_heap.h"
+#include "vertex_layout.h"
+#include "mesh_data.h"
+
+enum class VertexFormat {
+    Float,    // 32 byte vertex: float position / normal / texcoord, 32-bit indices
+    Compact,  // 16 byte vertex (CompactVertex), 16-bit indices when they fit
+};
+
+// index range plus everything needed to draw it, shared between meshes
+// with the same topology
+struct IndexBinding {
+    BufferAllocationPtr allocation;
+    uint32_t type { GL_UNSIGNED_INT };
+    uint32_t mode { GL_TRIANGLES };
+    int count { 0 };
+    int triangleCount { 0 };
+};
+
+// per-instance attributes of Mesh::DrawInstanced
+// model: locations 3-6 (one vec4 column each), color: location 7
+struct InstanceData {
+    glm::mat4 model;
+    glm::vec4 color;
+};
+
+CLASS_PTR(Mesh)
+class Mesh {
+public:
+    // vertices and indices are sub-allocated from the heaps (which must
+    // outlive the mesh), so many small meshes share a few GL buffers.
+    // indices: an already uploaded index range with the same topology
+    // and format. when given, data.indices is ignored and may be empty.
+    static MeshUPtr Create(const MeshData& data, BufferHeap* vertexHeap, BufferHeap* indexHeap,
+        VertexFormat format = VertexFormat::Float, const IndexBinding* indices = nullptr);
+
+    int GetVertexCount() const { return m_vertexCount; }
+    int GetTriangleCount() const { return m_indices.triangleCount; }
+    int GetIndexCount() const { return m_indices.count; }
+    uint32_t GetIndexType() const { return m_indices.type; }
+    uint32_t GetPrimitiveMode() const { return m_indices.mode; }
+    VertexFormat GetVertexFormat() const { return m_format; }
+    const IndexBinding& GetIndexBinding() const { return m_indices; }
+    size_t GetIndexBufferSize() const { return m_indices.allocation->size; }
+    size_t GetVertexBufferSize() const { return m_vertices->size; }
+
+    // compact positions are stored relative to the mesh bounds: multiply
+    // this onto the model matrix. identity for VertexFormat::Float
+    const glm::mat4& GetDequantizeTransform() const { return m_dequantize; }
+
+    // rewrites the vertex buffer in place; data must have the same vertex count
+    bool UpdateVertices(const MeshData& data);
+    void Draw() const;
+    // instances: array of InstanceData starting at offset, attached to
+    // this mesh's VAO
+    void DrawInstanced(const Buffer* instances, int instanceCount, size_t offset = 0) const;
+
+private:
+    Mesh() {}
+    bool Init(const MeshData& data, BufferHeap* vertexHeap, BufferHeap* indexHeap,
+        VertexFormat format, const IndexBinding* indices);
+    size_t GetVertexSize() const;
+    void WriteVertices(const MeshData& data, void* out);
+    void DrawElements(int instanceCount) const;
+
+    VertexFormat m_format { VertexFormat::Float };
+    VertexLayoutUPtr m_vertexLayout;
+    BufferAllocationPtr m_vertices;
+    IndexBinding m_indices;
+    int m_vertexCount { 0 };
+    // instance buffer / offset currently bound to attributes 3-7 of the VAO
+    mutable uint32_t m_instanceBuffer { 0 };
+    mutable size_t m_instanceOffset { 0 };
+    glm::mat4 m_dequantize { glm::mat4(1.0f) };
+};
+
+#endif // __MESH_H__
@@ -0,0 +1,121 @@
+#include "mesh_batch.h"
+
+// position(3) + normal(3) + texcoord(2), same layout as Mesh
+static const int kVertexFloatCount = 8;
+
+// GL 4.3 indirect draw command layout
+struct DrawElementsIndirectCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+};
+
+MeshBatchUPtr MeshBatch::Create(const std::vector<MeshBatchItem>& items,
+    BufferHeap* vertexHeap, BufferHeap* indexHeap) {
+    auto batch = MeshBatchUPtr(new MeshBatch());
+    batch->m_vertexHeap = vertexHeap;
+    batch->m_indexHeap = indexHeap;
+    if (!batch->Init(items))
+        return nullptr;
+    return std::move(batch);
+}
+
+MeshBatch::~MeshBatch() {
+    m_vertexHeap->Free(m_vertices);
+    m_indexHeap->Free(m_indices);
+}
+
+void MeshBatch::Draw() const {
+    m_vertexLayout->Bind();
+    if (m_indirectBuffer) {
+        m_indirectBuffer->Bind();
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, 0, GetDrawCount(), 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        return;
+    }
+    glMultiDrawElementsBaseVertex(GL_TRIANGLES, m_counts.data(), GL_UNSIGNED_INT,
+        m_offsets.data(), GetDrawCount(), m_baseVertices.data());
+}
+
+bool MeshBatch::Init(const std::vector<MeshBatchItem>& items) {
+    for (auto& item : items) {
+        if (!item.data || item.data->topology != PrimitiveTopology::Triangles) {
+            SPDLOG_ERROR("mesh batch only takes triangle list meshes");
+            return false;
+        }
+        m_vertexCount += item.data->GetVertexCount();
+        m_indexCount += item.data->indices.size();
+    }
+    if (items.empty())
+        return false;
+
+    std::vector<float> vertices(m_vertexCount * kVertexFloatCount);
+    std::vector<uint32_t> indices;
+    indices.reserve(m_indexCount);
+    std::vector<DrawElementsIndirectCommand> commands;
+    commands.reserve(items.size());
+
+    float* out = vertices.data();
+    size_t baseVertex = 0;
+    for (auto& item : items) {
+        const MeshData& data = *item.data;
+        // 정적인 물체이므로 변환을 정점에 미리 적용
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(item.transform)));
+        size_t vertexCount = data.GetVertexCount();
+        for (size_t i = 0; i < vertexCount; i++, out += kVertexFloatCount) {
+            glm::vec3 p = item.transform * glm::vec4(glm::make_vec3(&data.positions[i * 3]), 1.0f);
+            glm::vec3 n = glm::normalize(normalMatrix * glm::make_vec3(&data.normals[i * 3]));
+            out[0] = p.x; out[1] = p.y; out[2] = p.z;
+            out[3] = n.x; out[4] = n.y; out[5] = n.z;
+            out[6] = data.texCoords[i * 2]; out[7] = data.texCoords[i * 2 + 1];
+        }
+
+        DrawElementsIndirectCommand command;
+        command.count = (uint32_t)data.indices.size();
+        command.instanceCount = 1;
+        command.firstIndex = (uint32_t)indices.size();
+        command.baseVertex = (int32_t)baseVertex;
+        command.baseInstance = 0;
+        commands.push_back(command);
+
+        m_counts.push_back((GLsizei)command.count);
+        m_offsets.push_back(nullptr);  // set once the index range is known
+        m_baseVertices.push_back(command.baseVertex);
+
+        indices.insert(indices.end(), data.indices.begin(), data.indices.end());
+        baseVertex += vertexCount;
+    }
+
+    // heap의 블록은 자기 크기로 정렬되므로 stride(32)와 인덱스 크기의 배수
+    size_t stride = sizeof(float) * kVertexFloatCount;
+    m_vertices = m_vertexHeap->AllocateWithData(vertices.data(),
+        sizeof(float) * vertices.size(), stride);
+    m_indices = m_indexHeap->AllocateWithData(indices.data(),
+        sizeof(uint32_t) * indices.size(), sizeof(uint32_t));
+    if (!m_vertices.IsValid() || !m_indices.IsValid())
+        return false;
+
+    m_vertexLayout = VertexLayout::Create();
+    m_vertices.buffer->Bind();
+    m_vertexLayout->SetAttrib(0, 3, GL_FLOAT, GL_FALSE, stride, m_vertices.offset);
+    m_vertexLayout->SetAttrib(1, 3, GL_FLOAT, GL_FALSE, stride, m_vertices.offset + sizeof(float) * 3);
+    m_vertexLayout->SetAttrib(2, 2, GL_FLOAT, GL_FALSE, stride, m_vertices.offset + sizeof(float) * 6);
+    m_indices.buffer->Bind();
+
+    // 인덱스 위치를 heap 안의 절대 위치로
+    uint32_t firstIndex = (uint32_t)(m_indices.offset / sizeof(uint32_t));
+    for (size_t i = 0; i < commands.size(); i++) {
+        commands[i].firstIndex += firstIndex;
+        m_offsets[i] = (const void*)(sizeof(uint32_t) * commands[i].firstIndex);
+    }
+
+    // 4.3 이상이면 draw 목록 자체를 GPU 버퍼에 올림
+    if (GLAD_GL_VERSION_4_3 || GLAD_GL_ARB_multi_draw_indirect) {
+        m_indirectBuffer = Buffer::CreateWithData(GL_DRAW_INDIRECT_BUFFER, GL_STATIC_DRAW,
+            commands.data(), sizeof(DrawElementsIndirectCommand) * commands.size());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+    return true;
+}
@@ -0,0 +1,54 @@
+#ifndef __MESH_BATCH_H__
+#define __MESH_BATCH_H__
+
+#include "common.h"
+#include "buffer.h"
+#include "buffer_heap.h"
+#include "vertex_layout.h"
+#include "mesh_data.h"
+
+// one object of a static scene: shared geometry placed by a transform
+struct MeshBatchItem {
+    const MeshData* data { nullptr };
+    glm::mat4 transform { glm::mat4(1.0f) };
+};
+
+// static triangle list meshes packed into one vertex range, one index
+// range and one VAO. vertices are stored in world space and indices
+// stay mesh-local (base vertex), so the whole batch is a single
+// glMultiDrawElementsIndirect (GL 4.3) or glMultiDrawElementsBaseVertex.
+// the ranges come from the given heaps, which must outlive the batch
+CLASS_PTR(MeshBatch)
+class MeshBatch {
+public:
+    static MeshBatchUPtr Create(const std::vector<MeshBatchItem>& items,
+        BufferHeap* vertexHeap, BufferHeap* indexHeap);
+    ~MeshBatch();
+
+    int GetDrawCount() const { return (int)m_counts.size(); }
+    size_t GetVertexCount() const { return m_vertexCount; }
+    size_t GetTriangleCount() const { return m_indexCount / 3; }
+    bool IsIndirect() const { return m_indirectBuffer != nullptr; }
+
+    void Draw() const;
+
+private:
+    MeshBatch() {}
+    bool Init(const std::vector<MeshBatchItem>& items);
+
+    BufferHeap* m_vertexHeap { nullptr };
+    BufferHeap* m_indexHeap { nullptr };
+    VertexLayoutUPtr m_vertexLayout;
+    BufferAllocation m_vertices;
+    BufferAllocation m_indices;
+    BufferUPtr m_indirectBuffer;
+    size_t m_vertexCount { 0 };
+    size_t m_indexCount { 0 };
+
+    // glMultiDrawElementsBaseVertex arguments
+    std::vector<GLsizei> m_counts;
+    std::vector<const void*> m_offsets;
+    std::vector<GLint> m_baseVertices;
+};
+
+#endif // __MESH_BATCH_H__
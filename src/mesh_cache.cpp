@@ -0,0 +1,178 @@
+#include "mesh_cache.h"
+
+MeshKey MeshKey::Box() {
+    MeshKey key;
+    key.type = PrimitiveType::Box;
+    return key;
+}
+
+MeshKey MeshKey::Cylinder(float upperRadius, float lowerRadius, int segment, float height,
+    PrimitiveTopology topology) {
+    MeshKey key;
+    key.type = PrimitiveType::Cylinder;
+    key.topology = topology;
+    key.segments[0] = segment;
+    key.params[0] = upperRadius;
+    key.params[1] = lowerRadius;
+    key.params[2] = height;
+    return key;
+}
+
+MeshKey MeshKey::Sphere(float radius, int sectorCount, int stackCount,
+    PrimitiveTopology topology) {
+    MeshKey key;
+    key.type = PrimitiveType::Sphere;
+    key.topology = topology;
+    key.segments[0] = sectorCount;
+    key.segments[1] = stackCount;
+    key.params[0] = radius;
+    return key;
+}
+
+MeshKey MeshKey::Torus(float ringRadius, float tubeRadius, int ringSegment, int tubeSegment,
+    PrimitiveTopology topology) {
+    MeshKey key;
+    key.type = PrimitiveType::Torus;
+    key.topology = topology;
+    key.segments[0] = ringSegment;
+    key.segments[1] = tubeSegment;
+    key.params[0] = ringRadius;
+    key.params[1] = tubeRadius;
+    return key;
+}
+
+bool MeshKey::SameTopology(const MeshKey& other) const {
+    return type == other.type &&
+        segments[0] == other.segments[0] &&
+        segments[1] == other.segments[1] &&
+        topology == other.topology;
+}
+
+bool MeshKey::operator==(const MeshKey& other) const {
+    return type == other.type &&
+        segments[0] == other.segments[0] &&
+        segments[1] == other.segments[1] &&
+        topology == other.topology &&
+        params[0] == other.params[0] &&
+        params[1] == other.params[1] &&
+        params[2] == other.params[2];
+}
+
+MeshCacheUPtr MeshCache::Create(BufferHeap* vertexHeap, BufferHeap* indexHeap) {
+    auto cache = MeshCacheUPtr(new MeshCache());
+    cache->m_vertexHeap = vertexHeap;
+    cache->m_indexHeap = indexHeap;
+    return std::move(cache);
+}
+
+const Mesh* MeshCache::Get(const MeshKey& key) {
+    auto& entry = m_entries[(size_t)key.type];
+    if (entry.mesh && entry.key == key) {
+        m_stats.hits++;
+        return entry.mesh.get();
+    }
+
+    // 연결 구조가 같으면 정점만 다시 계산해서 기존 버퍼에 덮어씀
+    if (entry.mesh && entry.key.SameTopology(key)) {
+        if (entry.mesh->UpdateVertices(Generate(key, false))) {
+            m_stats.inPlaceUpdates++;
+            entry.key = key;
+            return entry.mesh.get();
+        }
+    }
+
+    if (entry.mesh)
+        m_stats.regenerations++;
+    else
+        m_stats.misses++;
+
+    // 이전 mesh를 먼저 놓아야 그 인덱스 버퍼가 정리 대상이 될 수 있음
+    entry.mesh.reset();
+    auto mesh = Build(key);
+    if (!mesh) {
+        SPDLOG_ERROR("failed to build mesh for primitive type {}", (int)key.type);
+        return nullptr;
+    }
+    entry.key = key;
+    entry.mesh = std::move(mesh);
+    return entry.mesh.get();
+}
+
+void MeshCache::SetOptimizeIndices(bool optimize) {
+    if (m_optimizeIndices == optimize)
+        return;
+    m_optimizeIndices = optimize;
+    Clear();
+}
+
+void MeshCache::SetVertexFormat(VertexFormat format) {
+    if (m_vertexFormat == format)
+        return;
+    m_vertexFormat = format;
+    Clear();
+}
+
+void MeshCache::Clear() {
+    for (auto& entry : m_entries)
+        entry.mesh.reset();
+    m_indexBuffers.clear();
+}
+
+MeshCache::TopologyKey MeshCache::GetTopologyKey(const MeshKey& key) {
+    return TopologyKey((int)key.type, key.segments[0], key.segments[1], (int)key.topology);
+}
+
+MeshData MeshCache::Generate(const MeshKey& key, bool generateIndices) const {
+    TessellationOptions options;
+    options.generateIndices = generateIndices;
+    options.topology = key.topology;
+    switch (key.type) {
+        case PrimitiveType::Box:
+            return GenerateBox();
+        case PrimitiveType::Cylinder:
+            return GenerateCylinder(key.params[0], key.params[1],
+                key.segments[0], key.params[2], options);
+        case PrimitiveType::Sphere:
+            return GenerateSphere(key.params[0],
+                key.segments[0], key.segments[1], options);
+        case PrimitiveType::Torus:
+            return GenerateTorus(key.params[0], key.params[1],
+                key.segments[0], key.segments[1], options);
+        default:
+            return MeshData();
+    }
+}
+
+MeshUPtr MeshCache::Build(const MeshKey& key) {
+    auto topology = GetTopologyKey(key);
+    auto found = m_indexBuffers.find(topology);
+    if (found != m_indexBuffers.end()) {
+        m_stats.sharedIndexBuffers++;
+        return Mesh::Create(Generate(key, false), m_vertexHeap, m_indexHeap,
+            m_vertexFormat, &found->second);
+    }
+
+    auto data = Generate(key, true);
+    if (m_optimizeIndices)
+        m_lastOptimizeReport = OptimizeMesh(data);
+    auto mesh = Mesh::Create(data, m_vertexHeap, m_indexHeap, m_vertexFormat);
+    if (!mesh)
+        return nullptr;
+
+    // 어떤 mesh도 쓰지 않는 인덱스 영역은 일정 개수까지만 보관
+    size_t idleCount = 0;
+    for (auto& pair : m_indexBuffers)
+        idleCount += pair.second.allocation.use_count() == 1 ? 1 : 0;
+    for (auto iter = m_indexBuffers.begin();
+        iter != m_indexBuffers.end() && idleCount >= kMaxIdleIndexBuffers;) {
+        if (iter->second.allocation.use_count() == 1) {
+            iter = m_indexBuffers.erase(iter);
+            idleCount--;
+        }
+        else {
+            ++iter;
+        }
+    }
+    m_indexBuffers[topology] = mesh->GetIndexBinding();
+    return std::move(mesh);
+}
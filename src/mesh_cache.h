@@ -0,0 +1,99 @@
+#ifndef __MESH_CACHE_H__
+#define __MESH_CACHE_H__
+
+#include "common.h"
+#include "mesh.h"
+#include "primitives.h"
+#include "mesh_optimizer.h"
+#include <array>
+#include <map>
+#include <tuple>
+
+enum class PrimitiveType {
+    Box,
+    Cylinder,
+    Sphere,
+    Torus,
+    Count,
+};
+
+// primitive type + every parameter that changes the generated geometry
+struct MeshKey {
+    PrimitiveType type { PrimitiveType::Box };
+    int segments[2] { 0, 0 };
+    float params[3] { 0.0f, 0.0f, 0.0f };
+    PrimitiveTopology topology { PrimitiveTopology::Triangles };  // ignored by Box
+
+    static MeshKey Box();
+    static MeshKey Cylinder(float upperRadius, float lowerRadius, int segment, float height,
+        PrimitiveTopology topology = PrimitiveTopology::Triangles);
+    static MeshKey Sphere(float radius, int sectorCount, int stackCount,
+        PrimitiveTopology topology = PrimitiveTopology::Triangles);
+    static MeshKey Torus(float ringRadius, float tubeRadius, int ringSegment, int tubeSegment,
+        PrimitiveTopology topology = PrimitiveTopology::Triangles);
+
+    // same type, segment counts and topology: identical connectivity, only
+    // the vertex positions differ
+    bool SameTopology(const MeshKey& other) const;
+    bool operator==(const MeshKey& other) const;
+    bool operator!=(const MeshKey& other) const { return !(*this == other); }
+};
+
+CLASS_PTR(MeshCache)
+class MeshCache {
+public:
+    struct Stats {
+        uint32_t hits { 0 };          // key unchanged, cached mesh reused
+        uint32_t misses { 0 };        // first request for a primitive type
+        uint32_t regenerations { 0 }; // segment counts changed, mesh rebuilt
+        uint32_t inPlaceUpdates { 0 }; // only radius/height changed, vertices rewritten
+        uint32_t sharedIndexBuffers { 0 }; // new mesh reused a cached index buffer
+    };
+
+    // meshes sub-allocate their vertex / index ranges from the heaps,
+    // which must outlive the cache
+    static MeshCacheUPtr Create(BufferHeap* vertexHeap, BufferHeap* indexHeap);
+
+    const Mesh* Get(const MeshKey& key);
+    const Stats& GetStats() const { return m_stats; }
+    void ResetStats() { m_stats = Stats(); }
+
+    // vertex cache / overdraw reordering of every newly uploaded index
+    // buffer. toggling it drops the cached meshes so the change is visible
+    void SetOptimizeIndices(bool optimize);
+    bool GetOptimizeIndices() const { return m_optimizeIndices; }
+    const MeshOptimizeReport& GetLastOptimizeReport() const { return m_lastOptimizeReport; }
+
+    // vertex / index encoding for newly built meshes, drops the cache too
+    void SetVertexFormat(VertexFormat format);
+    VertexFormat GetVertexFormat() const { return m_vertexFormat; }
+
+private:
+    MeshCache() {}
+    MeshData Generate(const MeshKey& key, bool generateIndices) const;
+    MeshUPtr Build(const MeshKey& key);
+    void Clear();
+
+    // one slot per primitive type: only the mesh for the current
+    // parameters is kept alive
+    struct Entry {
+        MeshKey key;
+        MeshUPtr mesh;
+    };
+    std::array<Entry, (size_t)PrimitiveType::Count> m_entries;
+
+    // index buffers by (type, segments[0], segments[1], topology)
+    using TopologyKey = std::tuple<int, int, int, int>;
+    static TopologyKey GetTopologyKey(const MeshKey& key);
+    std::map<TopologyKey, IndexBinding> m_indexBuffers;
+    static const size_t kMaxIdleIndexBuffers = 8;
+
+    BufferHeap* m_vertexHeap { nullptr };
+    BufferHeap* m_indexHeap { nullptr };
+    bool m_optimizeIndices { true };
+    VertexFormat m_vertexFormat { VertexFormat::Float };
+    MeshOptimizeReport m_lastOptimizeReport;
+    Stats m_stats;
+};
+
+#endif // __MESH_CACHE_H__
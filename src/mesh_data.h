@@ -0,0 +1,32 @@
+#ifndef __MESH_DATA_H__
+#define __MESH_DATA_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class PrimitiveTopology {
+    Triangles,      // independent triangles, 3 indices each
+    TriangleStrip,  // strips separated by kPrimitiveRestartIndex
+};
+
+// all bits set, matches GL_PRIMITIVE_RESTART_FIXED_INDEX for every index type
+static const uint32_t kPrimitiveRestartIndex = 0xFFFFFFFF;
+
+// CPU side geometry produced by the primitive generators.
+// Has no GL dependency so it can be built and profiled headless.
+struct MeshData {
+    std::vector<float> positions;   // xyz per vertex
+    std::vector<float> normals;     // xyz per vertex
+    std::vector<float> texCoords;   // uv per vertex
+    std::vector<uint32_t> indices;  // see topology
+    PrimitiveTopology topology { PrimitiveTopology::Triangles };
+    float boundsMin[3] { 0.0f, 0.0f, 0.0f };
+    float boundsMax[3] { 0.0f, 0.0f, 0.0f };
+
+    size_t GetVertexCount() const { return positions.size() / 3; }
+    size_t GetTriangleCount() const;
+    void ComputeBounds();
+};
+
+#endif // __MESH_DATA_H__
@@ -0,0 +1,277 @@
+#include "mesh_optimizer.h"
+#include <algorithm>
+#include <cmath>
+
+static VertexCacheStats SimulateVertexCache(const uint32_t* indices, size_t indexCount,
+    size_t triangleCount, size_t vertexCount, int cacheSize) {
+    VertexCacheStats stats;
+    if (triangleCount == 0 || vertexCount == 0)
+        return stats;
+
+    // a vertex is cached while fewer than cacheSize misses happened after it
+    // was loaded, which is exactly FIFO replacement
+    std::vector<uint32_t> loadedAt(vertexCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+    uint32_t misses = 0;
+    uint32_t uniqueCount = 0;
+    uint32_t timestamp = cacheSize + 1;
+    for (size_t i = 0; i < indexCount; i++) {
+        uint32_t v = indices[i];
+        if (v == kPrimitiveRestartIndex)
+            continue;
+        if (timestamp - loadedAt[v] > (uint32_t)cacheSize) {
+            loadedAt[v] = timestamp++;
+            misses++;
+        }
+        if (!referenced[v]) {
+            referenced[v] = true;
+            uniqueCount++;
+        }
+    }
+    stats.acmr = (float)misses / triangleCount;
+    stats.atvr = (float)misses / uniqueCount;
+    return stats;
+}
+
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount,
+    size_t vertexCount, int cacheSize) {
+    return SimulateVertexCache(indices, indexCount, indexCount / 3, vertexCount, cacheSize);
+}
+
+VertexCacheStats AnalyzeVertexCache(const MeshData& mesh, int cacheSize) {
+    return SimulateVertexCache(mesh.indices.data(), mesh.indices.size(),
+        mesh.GetTriangleCount(), mesh.GetVertexCount(), cacheSize);
+}
+
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount,
+    int cacheSize, std::vector<uint32_t>* clusters) {
+    size_t triangleCount = indexCount / 3;
+    if (clusters)
+        clusters->clear();
+    if (triangleCount == 0)
+        return;
+
+    // vertex -> triangle adjacency (CSR)
+    std::vector<uint32_t> liveCount(vertexCount, 0);
+    for (size_t i = 0; i < indexCount; i++)
+        liveCount[indices[i]]++;
+    std::vector<uint32_t> offsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; v++)
+        offsets[v + 1] = offsets[v] + liveCount[v];
+    std::vector<uint32_t> adjacency(indexCount);
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < indexCount; i++)
+        adjacency[fill[indices[i]]++] = (uint32_t)(i / 3);
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(indexCount);
+
+    uint32_t timestamp = cacheSize + 1;
+    size_t cursor = 0;
+    int64_t fanning = indices[0];
+    bool coldStart = true;
+
+    while (fanning >= 0) {
+        if (coldStart && clusters)
+            clusters->push_back((uint32_t)(output.size() / 3));
+        coldStart = false;
+
+        // emit every remaining triangle around the fanning vertex
+        candidates.clear();
+        for (uint32_t a = offsets[fanning]; a < offsets[fanning + 1]; a++) {
+            uint32_t triangle = adjacency[a];
+            if (emitted[triangle])
+                continue;
+            for (int k = 0; k < 3; k++) {
+                uint32_t v = indices[triangle * 3 + k];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                liveCount[v]--;
+                if (timestamp - cacheTime[v] > (uint32_t)cacheSize)
+                    cacheTime[v] = timestamp++;
+            }
+            emitted[triangle] = true;
+        }
+
+        // next fanning vertex: the candidate that stays in cache the
+        // longest while its remaining triangles still fit
+        int64_t next = -1;
+        int64_t bestPriority = -1;
+        for (uint32_t v : candidates) {
+            if (liveCount[v] == 0)
+                continue;
+            int64_t priority = 0;
+            if (timestamp - cacheTime[v] + 2 * liveCount[v] <= (uint32_t)cacheSize)
+                priority = timestamp - cacheTime[v];
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+
+        if (next < 0) {
+            // dead end: recently used vertices first, then scan in order
+            while (!deadEnd.empty() && next < 0) {
+                uint32_t v = deadEnd.back();
+                deadEnd.pop_back();
+                if (liveCount[v] > 0)
+                    next = v;
+            }
+            while (next < 0 && cursor < vertexCount) {
+                if (liveCount[cursor] > 0)
+                    next = (int64_t)cursor;
+                cursor++;
+            }
+            coldStart = true;
+        }
+        fanning = next;
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+static uint32_t UpdateCache(uint32_t a, uint32_t b, uint32_t c, int cacheSize,
+    std::vector<uint32_t>& cacheTime, uint32_t& timestamp) {
+    uint32_t misses = 0;
+    for (uint32_t v : { a, b, c }) {
+        if (timestamp - cacheTime[v] > (uint32_t)cacheSize) {
+            cacheTime[v] = timestamp++;
+            misses++;
+        }
+    }
+    return misses;
+}
+
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount,
+    const float* positions, size_t vertexCount,
+    const std::vector<uint32_t>& clusters, int cacheSize, float threshold) {
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0 || clusters.empty())
+        return;
+
+    // soft boundaries: inside each cold-cache cluster start a new one as
+    // soon as the running ACMR drops to the cluster average * threshold
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t timestamp = 0;
+    std::vector<uint32_t> boundaries;
+    for (size_t c = 0; c < clusters.size(); c++) {
+        uint32_t start = clusters[c];
+        uint32_t end = c + 1 < clusters.size() ? clusters[c + 1] : (uint32_t)triangleCount;
+        if (start >= end)
+            continue;
+
+        timestamp += cacheSize + 1;
+        uint32_t clusterMisses = 0;
+        for (uint32_t t = start; t < end; t++)
+            clusterMisses += UpdateCache(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2],
+                cacheSize, cacheTime, timestamp);
+        float clusterThreshold = threshold * clusterMisses / (end - start);
+
+        boundaries.push_back(start);
+        timestamp += cacheSize + 1;
+        uint32_t runningMisses = 0, runningTriangles = 0;
+        for (uint32_t t = start; t < end; t++) {
+            runningMisses += UpdateCache(indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2],
+                cacheSize, cacheTime, timestamp);
+            runningTriangles++;
+            if ((float)runningMisses / runningTriangles <= clusterThreshold) {
+                boundaries.push_back(t + 1);
+                timestamp += cacheSize + 1;
+                runningMisses = runningTriangles = 0;
+            }
+        }
+        if (boundaries.back() == end)
+            boundaries.pop_back();
+    }
+
+    // view independent sort key: how much the cluster faces away from the
+    // mesh center. those are likely in front, so draw them first
+    double meshCentroid[3] = { 0.0, 0.0, 0.0 };
+    double meshArea = 0.0;
+    struct Cluster {
+        uint32_t start, end;
+        double centroid[3], normal[3], area;
+        float sortKey;
+    };
+    std::vector<Cluster> sorted(boundaries.size());
+    for (size_t c = 0; c < boundaries.size(); c++) {
+        auto& cluster = sorted[c];
+        cluster.start = boundaries[c];
+        cluster.end = c + 1 < boundaries.size() ? boundaries[c + 1] : (uint32_t)triangleCount;
+        cluster.area = 0.0;
+        for (int k = 0; k < 3; k++)
+            cluster.centroid[k] = cluster.normal[k] = 0.0;
+        for (uint32_t t = cluster.start; t < cluster.end; t++) {
+            const float* p0 = positions + indices[t * 3] * 3;
+            const float* p1 = positions + indices[t * 3 + 1] * 3;
+            const float* p2 = positions + indices[t * 3 + 2] * 3;
+            double e1[3], e2[3];
+            for (int k = 0; k < 3; k++) {
+                e1[k] = p1[k] - p0[k];
+                e2[k] = p2[k] - p0[k];
+            }
+            double n[3] = {
+                e1[1] * e2[2] - e1[2] * e2[1],
+                e1[2] * e2[0] - e1[0] * e2[2],
+                e1[0] * e2[1] - e1[1] * e2[0],
+            };
+            double area = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int k = 0; k < 3; k++) {
+                double center = (p0[k] + p1[k] + p2[k]) / 3.0;
+                cluster.centroid[k] += center * area;
+                cluster.normal[k] += n[k];
+                meshCentroid[k] += center * area;
+            }
+            cluster.area += area;
+            meshArea += area;
+        }
+    }
+    for (int k = 0; k < 3; k++)
+        meshCentroid[k] = meshArea > 0.0 ? meshCentroid[k] / meshArea : 0.0;
+    for (auto& cluster : sorted) {
+        double length = std::sqrt(cluster.normal[0] * cluster.normal[0] +
+            cluster.normal[1] * cluster.normal[1] + cluster.normal[2] * cluster.normal[2]);
+        double key = 0.0;
+        for (int k = 0; k < 3; k++) {
+            double centroid = cluster.area > 0.0 ? cluster.centroid[k] / cluster.area : 0.0;
+            double normal = length > 0.0 ? cluster.normal[k] / length : 0.0;
+            key += (centroid - meshCentroid[k]) * normal;
+        }
+        cluster.sortKey = (float)key;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) {
+        return a.sortKey > b.sortKey;
+    });
+
+    std::vector<uint32_t> output;
+    output.reserve(indexCount);
+    for (auto& cluster : sorted)
+        output.insert(output.end(), indices + cluster.start * 3, indices + cluster.end * 3);
+    std::copy(output.begin(), output.end(), indices);
+}
+
+MeshOptimizeReport OptimizeMesh(MeshData& mesh, int cacheSize) {
+    MeshOptimizeReport report;
+    report.before = AnalyzeVertexCache(mesh, cacheSize);
+    if (mesh.topology != PrimitiveTopology::Triangles) {
+        // strip order is fixed by the connectivity, nothing to reorder
+        report.after = report.before;
+        return report;
+    }
+
+    size_t vertexCount = mesh.GetVertexCount();
+
+    std::vector<uint32_t> clusters;
+    OptimizeVertexCache(mesh.indices.data(), mesh.indices.size(), vertexCount,
+        cacheSize, &clusters);
+    OptimizeOverdraw(mesh.indices.data(), mesh.indices.size(),
+        mesh.positions.data(), vertexCount, clusters, cacheSize);
+
+    report.after = AnalyzeVertexCache(mesh, cacheSize);
+    return report;
+}
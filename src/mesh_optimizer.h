@@ -0,0 +1,43 @@
+#ifndef __MESH_OPTIMIZER_H__
+#define __MESH_OPTIMIZER_H__
+
+#include "mesh_data.h"
+
+// Index reordering for the post-transform vertex cache (Tipsify, Sander et
+// al. 2007) followed by an overdraw-aware cluster sort. Only the triangle
+// order changes; vertices stay where they are so in-place vertex updates
+// keep matching an optimized index buffer.
+
+struct VertexCacheStats {
+    float acmr { 0.0f };  // cache misses per triangle (ideal 0.5, worst 3)
+    float atvr { 0.0f };  // cache misses per referenced vertex (ideal 1)
+};
+
+// FIFO cache simulation of a triangle list
+VertexCacheStats AnalyzeVertexCache(const uint32_t* indices, size_t indexCount,
+    size_t vertexCount, int cacheSize = 16);
+// same for any topology: restart indices are skipped and misses are
+// divided by the real triangle count
+VertexCacheStats AnalyzeVertexCache(const MeshData& mesh, int cacheSize = 16);
+
+// reorders triangles in place. clusters (optional) receives the first
+// triangle of each run that starts with a cold cache
+void OptimizeVertexCache(uint32_t* indices, size_t indexCount, size_t vertexCount,
+    int cacheSize = 16, std::vector<uint32_t>* clusters = nullptr);
+
+// splits the clusters further while their ACMR stays within threshold of
+// the cluster average, then draws outward facing clusters first
+void OptimizeOverdraw(uint32_t* indices, size_t indexCount,
+    const float* positions, size_t vertexCount,
+    const std::vector<uint32_t>& clusters, int cacheSize = 16, float threshold = 1.05f);
+
+struct MeshOptimizeReport {
+    VertexCacheStats before;
+    VertexCacheStats after;
+};
+
+// vertex cache + overdraw pass over mesh.indices. triangle strips are
+// only analyzed
+MeshOptimizeReport OptimizeMesh(MeshData& mesh, int cacheSize = 16);
+
+#endif // __MESH_OPTIMIZER_H__
@@ -0,0 +1,375 @@
+#include "primitives.h"
+#include "ring.h"
+#include "worker_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+static const float pi = 3.14159265f;
+
+void MeshData::ComputeBounds() {
+    if (positions.empty()) {
+        std::fill(boundsMin, boundsMin + 3, 0.0f);
+        std::fill(boundsMax, boundsMax + 3, 0.0f);
+        return;
+    }
+    for (int k = 0; k < 3; k++)
+        boundsMin[k] = boundsMax[k] = positions[k];
+    for (size_t i = 3; i < positions.size(); i += 3) {
+        for (int k = 0; k < 3; k++) {
+            boundsMin[k] = std::min(boundsMin[k], positions[i + k]);
+            boundsMax[k] = std::max(boundsMax[k], positions[i + k]);
+        }
+    }
+}
+
+size_t MeshData::GetTriangleCount() const {
+    if (topology == PrimitiveTopology::Triangles)
+        return indices.size() / 3;
+    size_t count = 0, run = 0;
+    for (uint32_t index : indices) {
+        if (index == kPrimitiveRestartIndex) {
+            count += run > 2 ? run - 2 : 0;
+            run = 0;
+        }
+        else {
+            run++;
+        }
+    }
+    return count + (run > 2 ? run - 2 : 0);
+}
+
+static void Allocate(MeshData& mesh, size_t vertexCount, size_t indexCount) {
+    mesh.positions.resize(vertexCount * 3);
+    mesh.normals.resize(vertexCount * 3);
+    mesh.texCoords.resize(vertexCount * 2);
+    mesh.indices.resize(indexCount);
+}
+
+static void SetVertex(MeshData& mesh, size_t index,
+    float x, float y, float z,
+    float nx, float ny, float nz,
+    float s, float t) {
+    float* p = &mesh.positions[index * 3];
+    float* n = &mesh.normals[index * 3];
+    float* uv = &mesh.texCoords[index * 2];
+    p[0] = x; p[1] = y; p[2] = z;
+    n[0] = nx; n[1] = ny; n[2] = nz;
+    uv[0] = s; uv[1] = t;
+}
+
+static inline uint32_t* SetTriangle(uint32_t* out, uint32_t a, uint32_t b, uint32_t c) {
+    out[0] = a;
+    out[1] = b;
+    out[2] = c;
+    return out + 3;
+}
+
+// runs fn over [0, count) either inline or split across the worker pool.
+// every range writes its own pre-sized slice so the output is identical.
+static void ForEachRange(const TessellationOptions& options, size_t vertexCount,
+    int count, int grain, const std::function<void(int, int)>& fn) {
+    if (options.parallel && vertexCount >= options.parallelThreshold)
+        WorkerPool::Shared().ParallelFor(count, grain, fn);
+    else
+        fn(0, count);
+}
+
+//box
+MeshData GenerateBox() {
+    // 면마다 4개의 정점: 위치, uv
+    static const float faces[] = {
+        -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,
+         0.5f, -0.5f, -0.5f, 1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f, 0.0f, 1.0f,
+
+        -0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
+         0.5f, -0.5f,  0.5f, 1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f, 1.0f, 1.0f,
+        -0.5f,  0.5f,  0.5f, 0.0f, 1.0f,
+
+        -0.5f,  0.5f,  0.5f, 1.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
+        -0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
+
+         0.5f,  0.5f,  0.5f, 1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
+         0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
+         0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
+
+        -0.5f, -0.5f, -0.5f, 0.0f, 1.0f,
+         0.5f, -0.5f, -0.5f, 1.0f, 1.0f,
+         0.5f, -0.5f,  0.5f, 1.0f, 0.0f,
+        -0.5f, -0.5f,  0.5f, 0.0f, 0.0f,
+
+        -0.5f,  0.5f, -0.5f, 0.0f, 1.0f,
+         0.5f,  0.5f, -0.5f, 1.0f, 1.0f,
+         0.5f,  0.5f,  0.5f, 1.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f, 0.0f, 0.0f,
+    };
+    static const float faceNormals[] = {
+         0.0f,  0.0f, -1.0f,
+         0.0f,  0.0f,  1.0f,
+        -1.0f,  0.0f,  0.0f,
+         1.0f,  0.0f,  0.0f,
+         0.0f, -1.0f,  0.0f,
+         0.0f,  1.0f,  0.0f,
+    };
+    static const uint32_t indices[] = {
+        0,  2,  1,  2,  0,  3,
+        4,  5,  6,  6,  7,  4,
+        8,  9, 10, 10, 11,  8,
+        12, 14, 13, 14, 12, 15,
+        16, 17, 18, 18, 19, 16,
+        20, 22, 21, 22, 20, 23,
+    };
+
+    MeshData mesh;
+    Allocate(mesh, 24, 36);
+    for (int i = 0; i < 24; i++) {
+        const float* v = faces + i * 5;
+        const float* n = faceNormals + (i / 4) * 3;
+        SetVertex(mesh, i, v[0], v[1], v[2], n[0], n[1], n[2], v[3], v[4]);
+    }
+    std::copy(indices, indices + 36, mesh.indices.begin());
+    mesh.ComputeBounds();
+    return mesh;
+}
+
+//cylinder
+MeshData GenerateCylinder(float upperRadius, float lowerRadius, int segment, float height,
+    const TessellationOptions& options) {
+    MeshData mesh;
+    const float halfHeight = height / 2;
+
+    // 정점 순서: 아래 뚜껑(중심 + 원), 위 뚜껑(중심 + 원),
+    // 옆면 아래 원, 옆면 위 원 (옆면은 uv 이음새 때문에 segment + 1개)
+    const uint32_t bottomCenter = 0;
+    const uint32_t topCenter = segment + 1;
+    const uint32_t sideBottom = (segment + 1) * 2;
+    const uint32_t sideTop = sideBottom + segment + 1;
+    const size_t vertexCount = sideTop + segment + 1;
+    const bool strips = options.topology == PrimitiveTopology::TriangleStrip;
+    // strip: 뚜껑 2개(중심 없이 지그재그) + 옆면 1개, 사이에 restart
+    const size_t indexCount = strips ? segment * 4 + 4 : segment * 12;
+    Allocate(mesh, vertexCount, options.generateIndices ? indexCount : 0);
+    mesh.topology = options.topology;
+
+    // 뚜껑과 옆면이 같은 각도 테이블을 공유
+    auto table = MakeCircleTable(segment);
+    const float* sinTable = table.sin.data();
+    const float* cosTable = table.cos.data();
+    SetVertex(mesh, bottomCenter, 0.0f, -halfHeight, 0.0f, 0.0f, -1.0f, 0.0f, 0.5f, 0.5f);
+    SetVertex(mesh, topCenter, 0.0f, halfHeight, 0.0f, 0.0f, 1.0f, 0.0f, 0.5f, 0.5f);
+
+    //옆면: 반지름 차이만큼 법선을 기울임
+    const float slope = lowerRadius - upperRadius;
+    const float normalScale = 1.0f / sqrtf(height * height + slope * slope);
+
+    // [begin, end) 범위의 각도에 해당하는 정점과 삼각형을 채움
+    ForEachRange(options, vertexCount, segment + 1, 4096, [&](int begin, int end) {
+        int capEnd = std::min(end, segment);
+        //y축 -인 원, y축 +인 원
+        for (int cap = 0; cap < 2 && begin < capEnd; cap++) {
+            uint32_t first = (cap == 0 ? bottomCenter : topCenter) + 1 + begin;
+            float y = cap == 0 ? -halfHeight : halfHeight;
+            float ny = cap == 0 ? -1.0f : 1.0f;
+            EmitRing(table, begin, capEnd - begin, cap == 0 ? lowerRadius : upperRadius, y,
+                RingAxis::Y, &mesh.positions[first * 3]);
+            for (int i = begin; i < capEnd; i++) {
+                float* n = &mesh.normals[(first + i - begin) * 3];
+                float* uv = &mesh.texCoords[(first + i - begin) * 2];
+                n[0] = 0.0f; n[1] = ny; n[2] = 0.0f;
+                uv[0] = 0.5f + 0.5f * cosTable[i];
+                uv[1] = 0.5f - 0.5f * ny * sinTable[i];
+            }
+        }
+        for (int ring = 0; ring < 2; ring++) {
+            uint32_t first = (ring == 0 ? sideBottom : sideTop) + begin;
+            EmitRing(table, begin, end - begin, ring == 0 ? lowerRadius : upperRadius,
+                ring == 0 ? -halfHeight : halfHeight, RingAxis::Y, &mesh.positions[first * 3]);
+            EmitRing(table, begin, end - begin, height * normalScale, slope * normalScale,
+                RingAxis::Y, &mesh.normals[first * 3]);
+            for (int i = begin; i < end; i++) {
+                float* uv = &mesh.texCoords[(first + i - begin) * 2];
+                uv[0] = (float)i / segment;
+                uv[1] = (float)ring;
+            }
+        }
+
+        if (mesh.indices.empty() || strips)
+            return;
+        uint32_t* caps = mesh.indices.data() + begin * 6;
+        uint32_t* sides = mesh.indices.data() + (segment + begin) * 6;
+        for (int i = begin; i < capEnd; i++) {
+            uint32_t next = i + 1 == segment ? 0 : i + 1;
+            caps = SetTriangle(caps, bottomCenter, bottomCenter + 1 + i, bottomCenter + 1 + next);
+            caps = SetTriangle(caps, topCenter, topCenter + 1 + next, topCenter + 1 + i);
+            //원 사이를 채움
+            sides = SetTriangle(sides, sideBottom + i, sideTop + i, sideBottom + i + 1);
+            sides = SetTriangle(sides, sideTop + i, sideTop + i + 1, sideBottom + i + 1);
+        }
+    });
+
+    if (strips && !mesh.indices.empty()) {
+        uint32_t* out = mesh.indices.data();
+        // 볼록 다각형을 양 끝에서 번갈아 이어 붙임: 0, 1, n-1, 2, n-2, ...
+        // 위 뚜껑은 반대 방향이라 감는 순서를 뒤집음
+        for (int cap = 0; cap < 2; cap++) {
+            uint32_t first = (cap == 0 ? bottomCenter : topCenter) + 1;
+            int low = 1, high = segment - 1;
+            *out++ = first;
+            for (bool takeLow = cap == 0; low <= high; takeLow = !takeLow)
+                *out++ = first + (takeLow ? low++ : high--);
+            *out++ = kPrimitiveRestartIndex;
+        }
+        for (int i = 0; i <= segment; i++) {
+            *out++ = sideBottom + i;
+            *out++ = sideTop + i;
+        }
+    }
+
+    mesh.ComputeBounds();
+    return mesh;
+}
+
+// stack i의 첫 번째 인덱스 위치 (첫/마지막 stack은 삼각형이 절반)
+static size_t SphereIndexOffset(int stack, int sectorCount) {
+    return stack == 0 ? 0 : (size_t)sectorCount * 3 * (2 * stack - 1);
+}
+
+//sphere
+MeshData GenerateSphere(float radius, int sectorCount, int stackCount,
+    const TessellationOptions& options) {
+    MeshData mesh;
+    const int ringSize = sectorCount + 1;
+    const size_t vertexCount = (size_t)ringSize * (stackCount + 1);
+    const bool strips = options.topology == PrimitiveTopology::TriangleStrip;
+    // strip: stack마다 하나 (2 * ringSize) + restart
+    const size_t stripLength = (size_t)ringSize * 2 + 1;
+    const size_t indexCount = strips ? stripLength * stackCount - 1 :
+        (size_t)sectorCount * (stackCount - 1) * 6;
+    Allocate(mesh, vertexCount, options.generateIndices ? indexCount : 0);
+    mesh.topology = options.topology;
+
+    // sector 각도는 모든 stack에서 같으므로 한 번만 계산
+    auto sectors = MakeCircleTable(sectorCount);
+    std::vector<float> stackSin(stackCount + 1), stackCos(stackCount + 1);
+    ComputeSinCos(pi / 2, -pi / stackCount, stackCount + 1, stackSin.data(), stackCos.data());
+
+    int grain = std::max(1, 16384 / ringSize);
+    ForEachRange(options, vertexCount, stackCount + 1, grain, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            size_t first = (size_t)i * ringSize;
+            EmitRing(sectors, 0, ringSize, radius * stackCos[i], radius * stackSin[i],
+                RingAxis::Z, &mesh.positions[first * 3]);
+            EmitRing(sectors, 0, ringSize, stackCos[i], stackSin[i],
+                RingAxis::Z, &mesh.normals[first * 3]);
+            float t = 1.0f - (float)i / stackCount;
+            float* uv = &mesh.texCoords[first * 2];
+            for (int j = 0; j < ringSize; ++j) {
+                uv[j * 2] = (float)j / sectorCount;
+                uv[j * 2 + 1] = t;
+            }
+        }
+
+        if (mesh.indices.empty())
+            return;
+        if (strips) {
+            // k1, k2, k1 + 1, k2 + 1, ... : 삼각형 리스트와 같은 대각선, 같은 감는 방향
+            // (극점 stack의 퇴화 삼각형은 래스터라이저가 버림)
+            for (int i = begin; i < std::min(end, stackCount); ++i) {
+                uint32_t* out = mesh.indices.data() + stripLength * i;
+                uint32_t k1 = i * ringSize;
+                for (int j = 0; j < ringSize; ++j) {
+                    *out++ = k1 + j;
+                    *out++ = k1 + ringSize + j;
+                }
+                if (i + 1 < stackCount)
+                    *out = kPrimitiveRestartIndex;
+            }
+            return;
+        }
+        uint32_t* out = mesh.indices.data() + SphereIndexOffset(begin, sectorCount);
+        for (int i = begin; i < std::min(end, stackCount); ++i) {
+            uint32_t k1 = i * ringSize;
+            uint32_t k2 = k1 + ringSize;
+
+            for (int j = 0; j < sectorCount; ++j, ++k1, ++k2) {
+                if (i != 0)
+                    out = SetTriangle(out, k1, k2, k1 + 1);
+                if (i != (stackCount - 1))
+                    out = SetTriangle(out, k1 + 1, k2, k2 + 1);
+            }
+        }
+    });
+
+    mesh.ComputeBounds();
+    return mesh;
+}
+
+//torus
+MeshData GenerateTorus(float ringRadius, float tubeRadius, int ringSegment, int tubeSegment,
+    const TessellationOptions& options) {
+    MeshData mesh;
+    const int ringSize = ringSegment + 1;
+    const size_t vertexCount = (size_t)ringSize * (tubeSegment + 1);
+    const bool strips = options.topology == PrimitiveTopology::TriangleStrip;
+    const size_t stripLength = (size_t)ringSize * 2 + 1;
+    const size_t indexCount = strips ? stripLength * tubeSegment - 1 :
+        (size_t)ringSegment * tubeSegment * 6;
+    Allocate(mesh, vertexCount, options.generateIndices ? indexCount : 0);
+    mesh.topology = options.topology;
+
+    // 튜브 단면의 각 각도마다 z축을 도는 원 하나씩 (행 = tube, 열 = ring)
+    auto rings = MakeCircleTable(ringSegment);
+    auto tubes = MakeCircleTable(tubeSegment);
+
+    int grain = std::max(1, 16384 / ringSize);
+    ForEachRange(options, vertexCount, tubeSegment + 1, grain, [&](int begin, int end) {
+        for (int j = begin; j < end; ++j) {
+            size_t first = (size_t)j * ringSize;
+            EmitRing(rings, 0, ringSize, ringRadius + tubeRadius * tubes.cos[j],
+                tubeRadius * tubes.sin[j], RingAxis::Z, &mesh.positions[first * 3]);
+            EmitRing(rings, 0, ringSize, tubes.cos[j], tubes.sin[j],
+                RingAxis::Z, &mesh.normals[first * 3]);
+            float t = (float)j / tubeSegment;
+            float* uv = &mesh.texCoords[first * 2];
+            for (int i = 0; i < ringSize; ++i) {
+                uv[i * 2] = (float)i / ringSegment;
+                uv[i * 2 + 1] = t;
+            }
+        }
+
+        if (mesh.indices.empty())
+            return;
+        if (strips) {
+            // k2, k1, k2 + 1, k1 + 1, ... : 바깥쪽이 앞면
+            for (int j = begin; j < std::min(end, tubeSegment); ++j) {
+                uint32_t* out = mesh.indices.data() + stripLength * j;
+                uint32_t k1 = j * ringSize;
+                for (int i = 0; i < ringSize; ++i) {
+                    *out++ = k1 + ringSize + i;
+                    *out++ = k1 + i;
+                }
+                if (j + 1 < tubeSegment)
+                    *out = kPrimitiveRestartIndex;
+            }
+            return;
+        }
+        uint32_t* out = mesh.indices.data() + (size_t)begin * ringSegment * 6;
+        for (int j = begin; j < std::min(end, tubeSegment); ++j) {
+            uint32_t k1 = j * ringSize;
+            uint32_t k2 = k1 + ringSize;
+            for (int i = 0; i < ringSegment; ++i, ++k1, ++k2) {
+                out = SetTriangle(out, k1, k1 + 1, k2);
+                out = SetTriangle(out, k1 + 1, k2 + 1, k2);
+            }
+        }
+    });
+
+    mesh.ComputeBounds();
+    return mesh;
+}
@@ -0,0 +1,28 @@
+#ifndef __PRIMITIVES_H__
+#define __PRIMITIVES_H__
+
+#include "mesh_data.h"
+
+struct TessellationOptions {
+    // split rings / stacks across WorkerPool::Shared()
+    bool parallel { true };
+    // meshes with fewer vertices than this stay on the calling thread
+    size_t parallelThreshold { 1 << 16 };
+    // false: leave MeshData::indices empty, for callers that only refresh
+    // vertex positions of a topology they already uploaded
+    bool generateIndices { true };
+    // strips: one per stack / tube ring / cylinder side and cap (the box
+    // is always a triangle list)
+    PrimitiveTopology topology { PrimitiveTopology::Triangles };
+};
+
+MeshData GenerateBox();
+MeshData GenerateCylinder(float upperRadius, float lowerRadius, int segment, float height,
+    const TessellationOptions& options = TessellationOptions());
+MeshData GenerateSphere(float radius, int sectorCount, int stackCount,
+    const TessellationOptions& options = TessellationOptions());
+// ringRadius: center to tube center, tubeRadius: tube cross section
+MeshData GenerateTorus(float ringRadius, float tubeRadius, int ringSegment, int tubeSegment,
+    const TessellationOptions& options = TessellationOptions());
+
+#endif // __PRIMITIVES_H__
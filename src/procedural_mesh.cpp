@@ -0,0 +1,43 @@
+#include "procedural_mesh.h"
+
+ProceduralMeshUPtr ProceduralMesh::Create() {
+    auto mesh = ProceduralMeshUPtr(new ProceduralMesh());
+    mesh->Init();
+    return std::move(mesh);
+}
+
+void ProceduralMesh::Init() {
+    m_emptyLayout = VertexLayout::Create();
+}
+
+bool ProceduralMesh::IsSupported(PrimitiveType type) {
+    return type == PrimitiveType::Cylinder ||
+        type == PrimitiveType::Sphere ||
+        type == PrimitiveType::Torus;
+}
+
+int ProceduralMesh::GetVertexCount(const MeshKey& key) {
+    switch (key.type) {
+        case PrimitiveType::Cylinder:
+            return key.segments[0] * 12;
+        case PrimitiveType::Sphere:
+        case PrimitiveType::Torus:
+            return key.segments[0] * key.segments[1] * 6;
+        default:
+            return 0;
+    }
+}
+
+static constexpr UniformName kPrimitiveTypeUniform("primitiveType");
+static constexpr UniformName kSegmentsUniform("segments");
+static constexpr UniformName kParamsUniform("params");
+
+void ProceduralMesh::Draw(Program* program, const MeshKey& key) const {
+    if (!IsSupported(key.type))
+        return;
+    program->SetUniform(kPrimitiveTypeUniform, (int)key.type);
+    program->SetUniform(kSegmentsUniform, glm::ivec2(key.segments[0], key.segments[1]));
+    program->SetUniform(kParamsUniform, glm::vec3(key.params[0], key.params[1], key.params[2]));
+    m_emptyLayout->Bind();
+    glDrawArrays(GL_TRIANGLES, 0, GetVertexCount(key));
+}
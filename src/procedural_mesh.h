@@ -0,0 +1,32 @@
+#ifndef __PROCEDURAL_MESH_H__
+#define __PROCEDURAL_MESH_H__
+
+#include "common.h"
+#include "program.h"
+#include "vertex_layout.h"
+#include "mesh_cache.h"
+
+// draws cylinder / sphere / torus without any vertex or index buffer:
+// shader/procedural.vs computes every vertex from gl_VertexID and the
+// MeshKey parameters, so changing them costs no CPU work or upload
+CLASS_PTR(ProceduralMesh)
+class ProceduralMesh {
+public:
+    static ProceduralMeshUPtr Create();
+
+    static bool IsSupported(PrimitiveType type);
+    // non-indexed triangle list, pole triangles of the sphere included
+    static int GetVertexCount(const MeshKey& key);
+
+    // program must be in use with procedural.vs linked
+    void Draw(Program* program, const MeshKey& key) const;
+
+private:
+    ProceduralMesh() {}
+    void Init();
+
+    // core profile는 VAO가 바인딩되어 있어야 draw 가능
+    VertexLayoutUPtr m_emptyLayout;
+};
+
+#endif // __PROCEDURAL_MESH_H__
@@ -1,45 +1,237 @@
 #include "program.h"
+#include "uniform_buffer.h"
+#include <algorithm>
+#include <cstring>
 
-ProgramUPtr Program::Create(const std::vector<ShaderPtr>& shaders) {
+ProgramUPtr Program::CreateFromBinary(uint32_t format, const void* data, size_t size) {
     auto program = ProgramUPtr(new Program());
-    if (!program->Link(shaders))
+    if (!program->LoadBinary(format, data, size))
         return nullptr;
     return std::move(program);
 }
 
+bool Program::IsBinarySupported() {
+    if (!GLAD_GL_VERSION_4_1 && !GLAD_GL_ARB_get_program_binary)
+        return false;
+    int formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    return formatCount > 0;
+}
+
+ProgramUPtr Program::CreateDeferred(const std::vector<ShaderPtr>& shaders) {
+    auto program = ProgramUPtr(new Program());
+    program->SubmitLink(shaders);
+    return std::move(program);
+}
+
+bool Program::IsParallelCompileSupported() {
+    return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+}
+
 Program::~Program() {
+    if (m_linkFence)
+        glDeleteSync(m_linkFence);
      if (m_program) {
         glDeleteProgram(m_program);
   }
 }
 
-bool Program::Link(const std::vector<ShaderPtr>& shaders) {
+void Program::SubmitLink(const std::vector<ShaderPtr>& shaders) {
     m_program = glCreateProgram();
     for (auto& shader: shaders)
         glAttachShader(m_program, shader->Get());
+    // 링크 결과를 디스크 캐시에 저장할 수 있게 요청
+    if (IsBinarySupported())
+        glProgramParameteri(m_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     glLinkProgram(m_program);
+    // 확장이 없으면 링크 뒤의 fence가 signal될 때까지 결과 확인을 미룸
+    if (!IsParallelCompileSupported())
+        m_linkFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    // 결과 확인 전까지 컴파일 에러 로그를 위해 보관
+    m_pendingShaders = shaders;
+    m_linkState = LinkState::Pending;
+}
+
+bool Program::IsLinkComplete() const {
+    if (m_linkState != LinkState::Pending)
+        return true;
+    if (!IsParallelCompileSupported())
+        return !m_linkFence || glClientWaitSync(m_linkFence, 0, 0) != GL_TIMEOUT_EXPIRED;
+    // 드라이버의 컴파일 스레드가 끝났는지만 확인 (대기하지 않음)
+    int complete = 0;
+    glGetProgramiv(m_program, GL_COMPLETION_STATUS_KHR, &complete);
+    return complete != 0;
+}
+
+bool Program::FinishLink() {
+    if (m_linkState != LinkState::Pending)
+        return m_linkState == LinkState::Linked;
+    if (m_linkFence) {
+        glDeleteSync(m_linkFence);
+        m_linkFence = nullptr;
+    }
 
     int success = 0;
     glGetProgramiv(m_program, GL_LINK_STATUS, &success);
     if (!success) {
+        // 링크 실패의 대부분은 컴파일 실패이므로 shader 로그를 먼저 출력
+        for (auto& shader: m_pendingShaders)
+            shader->CheckCompileStatus();
         char infoLog[1024];
         glGetProgramInfoLog(m_program, 1024, nullptr, infoLog);
         SPDLOG_ERROR("failed to link program: {}", infoLog);
+        m_pendingShaders.clear();
+        m_linkState = LinkState::Failed;
         return false;
   }
+  m_pendingShaders.clear();
+  m_linkState = LinkState::Linked;
+  ReflectUniforms();
+  BindUniformBlocks();
   return true;
 }
 
+void Program::BindUniformBlocks() {
+    // 등록된 이름의 uniform block은 공용 binding point에 연결
+    int count = 0;
+    glGetProgramiv(m_program, GL_ACTIVE_UNIFORM_BLOCKS, &count);
+    for (int i = 0; i < count; i++) {
+        char name[256];
+        glGetActiveUniformBlockName(m_program, (GLuint)i, sizeof(name), nullptr, name);
+        int binding = UniformBlockBindings::Find(name);
+        if (binding < 0) {
+            SPDLOG_WARN("uniform block {} has no registered binding point", name);
+            continue;
+        }
+        glUniformBlockBinding(m_program, (GLuint)i, (GLuint)binding);
+    }
+}
+
+bool Program::LoadBinary(uint32_t format, const void* data, size_t size) {
+    m_program = glCreateProgram();
+    glProgramBinary(m_program, format, data, (GLsizei)size);
+    int success = 0;
+    glGetProgramiv(m_program, GL_LINK_STATUS, &success);
+    if (!success)
+        return false;
+    m_linkState = LinkState::Linked;
+    ReflectUniforms();
+    BindUniformBlocks();
+    return true;
+}
+
+bool Program::GetBinary(uint32_t* format, std::vector<uint8_t>* data) const {
+    int length = 0;
+    glGetProgramiv(m_program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return false;
+    data->resize(length);
+    GLenum binaryFormat = 0;
+    glGetProgramBinary(m_program, length, nullptr, &binaryFormat, data->data());
+    *format = binaryFormat;
+    return true;
+}
+
+void Program::ReflectUniforms() {
+    // 링크 직후 활성 uniform 목록을 한 번만 조회해서 이름 해시로 저장
+    int count = 0;
+    glGetProgramiv(m_program, GL_ACTIVE_UNIFORMS, &count);
+    m_uniforms.clear();
+    m_uniforms.reserve(count);
+    // 충돌 보고용
+    std::vector<std::string> names;
+    for (int i = 0; i < count; i++) {
+        char name[256];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_program, (GLuint)i, sizeof(name), &length, &size, &type, name);
+        // uniform block 멤버는 location이 없음
+        int location = glGetUniformLocation(m_program, name);
+        if (location < 0)
+            continue;
+        // 배열은 "name[0]"으로 나오므로 첫 원소 이름으로 등록
+        if (length > 3 && strcmp(name + length - 3, "[0]") == 0)
+            length -= 3;
+        Uniform uniform;
+        uniform.hash = UniformName::Hash(name, (size_t)length);
+        uniform.location = location;
+        uniform.type = type;
+        // 조회는 해시만 비교하므로 충돌하면 한쪽 값이 다른 uniform으로 감
+        auto duplicate = std::find_if(m_uniforms.begin(), m_uniforms.end(),
+            [&](const Uniform& other) { return other.hash == uniform.hash; });
+        if (duplicate != m_uniforms.end()) {
+            SPDLOG_ERROR("uniforms \"{}\" and \"{}\" have the same name hash {:08x}, rename one",
+                names[duplicate - m_uniforms.begin()], std::string(name, length), uniform.hash);
+            continue;
+        }
+        m_uniforms.push_back(uniform);
+        names.push_back(std::string(name, length));
+    }
+}
+
+Program::Uniform* Program::FindUniform(UniformName name) {
+    for (auto& uniform : m_uniforms) {
+        if (uniform.hash == name.hash)
+            return &uniform;
+    }
+    return nullptr;
+}
+
+int Program::GetUniformLocation(UniformName name) const {
+    for (auto& uniform : m_uniforms) {
+        if (uniform.hash == name.hash)
+            return uniform.location;
+    }
+    return -1;
+}
+
+bool Program::Changed(Uniform* uniform, const void* data, size_t size) {
+    if (uniform->valid && memcmp(uniform->value, data, size) == 0) {
+        m_skippedUniforms++;
+        return false;
+    }
+    memcpy(uniform->value, data, size);
+    uniform->valid = true;
+    return true;
+}
+
 void Program::Use() const {
     glUseProgram(m_program);
 }
 
-void Program::SetUniform(const std::string& name, int value) const {
-    auto loc = glGetUniformLocation(m_program, name.c_str());
-glUniform1i(loc, value);
+void Program::SetUniform(UniformName name, int value) {
+    auto uniform = FindUniform(name);
+    if (uniform && Changed(uniform, &value, sizeof(value)))
+        glUniform1i(uniform->location, value);
+}
+
+void Program::SetUniform(UniformName name, float value) {
+    auto uniform = FindUniform(name);
+    if (uniform && Changed(uniform, &value, sizeof(value)))
+        glUniform1f(uniform->location, value);
+}
+
+void Program::SetUniform(UniformName name, const glm::ivec2& value) {
+    auto uniform = FindUniform(name);
+    if (uniform && Changed(uniform, glm::value_ptr(value), sizeof(value)))
+        glUniform2iv(uniform->location, 1, glm::value_ptr(value));
+}
+
+void Program::SetUniform(UniformName name, const glm::vec3& value) {
+    auto uniform = FindUniform(name);
+    if (uniform && Changed(uniform, glm::value_ptr(value), sizeof(value)))
+        glUniform3fv(uniform->location, 1, glm::value_ptr(value));
+}
+
+void Program::SetUniform(UniformName name, const glm::vec4& value) {
+    auto uniform = FindUniform(name);
+    if (uniform && Changed(uniform, glm::value_ptr(value), sizeof(value)))
+        glUniform4fv(uniform->location, 1, glm::value_ptr(value));
 }
 
-void Program::SetUniform(const std::string& name, const glm::mat4& value) const {
-    auto loc = glGetUniformLocation(m_program, name.c_str());
-    glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(value));
+void Program::SetUniform(UniformName name, const glm::mat4& value) {
+    auto uniform = FindUniform(name);
+    if (uniform && Changed(uniform, glm::value_ptr(value), sizeof(value)))
+        glUniformMatrix4fv(uniform->location, 1, GL_FALSE, glm::value_ptr(value));
 }
\ No newline at end of file
@@ -4,24 +4,105 @@
 #include "common.h"
 #include "shader.h"
 
+// FNV-1a hash of a uniform name, computed at compile time when the name
+// is a constant (e.g. static constexpr UniformName kTransform("transform"))
+struct UniformName {
+    uint32_t hash;
+
+    static constexpr uint32_t Hash(const char* text, size_t length) {
+        uint32_t value = 2166136261u;
+        for (size_t i = 0; i < length; i++)
+            value = (value ^ (uint8_t)text[i]) * 16777619u;
+        return value;
+    }
+    static constexpr size_t Length(const char* text) {
+        size_t length = 0;
+        while (text[length])
+            length++;
+        return length;
+    }
+
+    constexpr UniformName(const char* text) : hash(Hash(text, Length(text))) {}
+    UniformName(const std::string& text) : hash(Hash(text.c_str(), text.length())) {}
+};
+
 CLASS_PTR(Program)
 class Program {
 public:
-    static ProgramUPtr Create(
+    // glProgramBinary blob from GetBinary. nullptr (without an error log)
+    // if the driver rejects it, e.g. after a driver update
+    static ProgramUPtr CreateFromBinary(uint32_t format, const void* data, size_t size);
+
+    // GL 4.1 / ARB_get_program_binary with at least one binary format
+    static bool IsBinarySupported();
+
+    // issues glLinkProgram without checking the result. poll IsLinkComplete
+    // and call FinishLink before the first Use
+    static ProgramUPtr CreateDeferred(
         const std::vector<ShaderPtr>& shaders);
+    // KHR / ARB_parallel_shader_compile: compiles run on driver threads and
+    // completion can be polled without blocking
+    static bool IsParallelCompileSupported();
 
     ~Program();
     uint32_t Get() const { return m_program; }    
     void Use() const;
 
-    void SetUniform(const std::string& name, int value) const;
-    void SetUniform(const std::string& name, const glm::mat4& value) const;
+    // the program must be in use. values equal to the last upload are
+    // skipped; names that are not active uniforms are ignored
+    void SetUniform(UniformName name, int value);
+    void SetUniform(UniformName name, float value);
+    void SetUniform(UniformName name, const glm::ivec2& value);
+    void SetUniform(UniformName name, const glm::vec3& value);
+    void SetUniform(UniformName name, const glm::vec4& value);
+    void SetUniform(UniformName name, const glm::mat4& value);
+
+    bool GetBinary(uint32_t* format, std::vector<uint8_t>* data) const;
+
+    // deferred link: IsLinkComplete never blocks, FinishLink blocks until
+    // the result is known and must succeed before the program is used.
+    // without parallel compile support completion is approximated by a
+    // fence issued after glLinkProgram; drivers that link inside the
+    // glLinkProgram call itself stall there instead
+    bool IsLinkComplete() const;
+    bool FinishLink();
+    bool IsLinked() const { return m_linkState == LinkState::Linked; }
+
+    // -1 if name is not an active uniform
+    int GetUniformLocation(UniformName name) const;
+    // uploads skipped because the value did not change
+    uint32_t GetSkippedUniformCount() const { return m_skippedUniforms; }
     
 private:
     Program() {}
-    bool Link(
-        const std::vector<ShaderPtr>& shaders);
+    void SubmitLink(const std::vector<ShaderPtr>& shaders);
+    bool LoadBinary(uint32_t format, const void* data, size_t size);
+    void ReflectUniforms();
+    void BindUniformBlocks();
+
+    // active uniform from glGetActiveUniform. the last uploaded value is
+    // kept in value (large enough for a mat4)
+    struct Uniform {
+        uint32_t hash { 0 };
+        int location { -1 };
+        uint32_t type { 0 };
+        bool valid { false };
+        uint8_t value[sizeof(float) * 16];
+    };
+    Uniform* FindUniform(UniformName name);
+    // true if data differs from the shadow copy (which is then updated)
+    bool Changed(Uniform* uniform, const void* data, size_t size);
+
     uint32_t m_program { 0 };
+    enum class LinkState { Pending, Linked, Failed };
+    LinkState m_linkState { LinkState::Failed };
+    // GL_COMPLETION_STATUS_KHR 대신 쓰는 fence (parallel compile 미지원)
+    GLsync m_linkFence { nullptr };
+    // kept alive until FinishLink to report compile errors
+    std::vector<ShaderPtr> m_pendingShaders;
+    // flat table, a handful of entries so a linear scan over hashes is cheapest
+    std::vector<Uniform> m_uniforms;
+    uint32_t m_skippedUniforms { 0 };
 };
 
-#endif // __PROGRAM_H__
\ No newline at end of file
+#endif // __PROGRAM_H__
@@ -0,0 +1,174 @@
+#include "program_batch.h"
+
+ProgramBatchUPtr ProgramBatch::Create(ProgramCache* cache) {
+    auto batch = ProgramBatchUPtr(new ProgramBatch());
+    if (!batch->Init(cache))
+        return nullptr;
+    return std::move(batch);
+}
+
+bool ProgramBatch::Init(ProgramCache* cache) {
+    m_cache = cache;
+    // 0xFFFFFFFF: 스레드 수는 드라이버가 결정
+    if (GLAD_GL_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    else if (GLAD_GL_ARB_parallel_shader_compile)
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+    SPDLOG_INFO("parallel shader compile: {}",
+        Program::IsParallelCompileSupported() ? "supported" : "not supported");
+    return true;
+}
+
+size_t ProgramBatch::Add(const std::vector<std::pair<std::string, GLenum>>& files,
+    const std::vector<std::string>& defines) {
+    Entry entry;
+    entry.files = files;
+    entry.defines = defines;
+    m_entries.push_back(std::move(entry));
+    return m_entries.size() - 1;
+}
+
+void ProgramBatch::Submit() {
+    // 전처리 결과가 같은 shader는 한 번만 컴파일해서 여러 program이 공유
+    std::map<std::pair<GLenum, std::string>, ShaderPtr> shaders;
+    std::vector<std::vector<ShaderPtr>> stages(m_entries.size());
+
+    // 1. 모든 shader의 컴파일을 먼저 요청
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        auto& entry = m_entries[i];
+        if (entry.state != State::Queued)
+            continue;
+        for (auto& file : entry.files) {
+            auto source = ShaderSource::Load(file.first, file.second, entry.defines);
+            if (!source.has_value()) {
+                entry.state = State::Failed;
+                break;
+            }
+            entry.sources.push_back(std::move(source.value()));
+        }
+        if (entry.state == State::Failed)
+            continue;
+
+        if (m_cache) {
+            entry.program = m_cache->Find(entry.sources);
+            if (entry.program) {
+                entry.state = State::Ready;
+                continue;
+            }
+        }
+        for (auto& source : entry.sources) {
+            auto& shader = shaders[{ source.type, source.code }];
+            if (!shader)
+                shader = Shader::CreateDeferred(source);
+            stages[i].push_back(shader);
+        }
+    }
+
+    // 2. 그 다음 링크 요청. 결과는 Get에서 처음 필요할 때 확인
+    for (size_t i = 0; i < m_entries.size(); i++) {
+        if (stages[i].empty())
+            continue;
+        m_entries[i].program = Program::CreateDeferred(stages[i]);
+        m_entries[i].state = State::Pending;
+    }
+}
+
+Program* ProgramBatch::Get(size_t slot) {
+    auto& entry = m_entries[slot];
+    if (entry.reload && entry.reload->IsLinkComplete())
+        FinishReload(slot);
+    if (entry.state == State::Pending && entry.program->IsLinkComplete())
+        Finish(slot);
+    return entry.state == State::Ready ? entry.program.get() : nullptr;
+}
+
+Program* ProgramBatch::Wait(size_t slot) {
+    auto& entry = m_entries[slot];
+    if (entry.state == State::Pending)
+        Finish(slot);
+    return entry.state == State::Ready ? entry.program.get() : nullptr;
+}
+
+bool ProgramBatch::IsPending(size_t slot) const {
+    auto state = m_entries[slot].state;
+    return state == State::Queued || state == State::Pending;
+}
+
+bool ProgramBatch::IsFailed(size_t slot) const {
+    return m_entries[slot].state == State::Failed;
+}
+
+void ProgramBatch::Finish(size_t slot) {
+    auto& entry = m_entries[slot];
+    if (!entry.program->FinishLink()) {
+        entry.state = State::Failed;
+        entry.program.reset();
+        return;
+    }
+    entry.state = State::Ready;
+    if (m_cache)
+        m_cache->Store(entry.sources, entry.program.get());
+}
+
+size_t ProgramBatch::Reload(const std::map<std::string, std::string>& files) {
+    std::map<std::pair<GLenum, std::string>, ShaderPtr> shaders;
+    size_t count = 0;
+    for (auto& entry : m_entries) {
+        // 진행 중인 reload가 있으면 그 소스를 기준으로 (연속 저장)
+        auto sources = entry.reload ? entry.reloadSources : entry.sources;
+        bool changed = false;
+        for (auto& source : sources) {
+            bool uses = false;
+            for (auto& file : files)
+                uses = uses || source.files.count(file.first) > 0;
+            if (!uses)
+                continue;
+            // 바뀐 파일은 새 내용, 나머지는 지난번 내용으로 다시 전처리 (디스크 접근 없음)
+            auto reader = [&](const std::string& filename) -> std::optional<std::string> {
+                auto file = files.find(filename);
+                if (file != files.end())
+                    return file->second;
+                auto previous = source.files.find(filename);
+                if (previous != source.files.end())
+                    return previous->second;
+                return LoadTextFile(filename);
+            };
+            auto reloaded = ShaderSource::Load(source.filename, source.type, source.defines, reader);
+            if (!reloaded.has_value() || reloaded->code == source.code)
+                continue;
+            source = std::move(reloaded.value());
+            changed = true;
+        }
+        if (!changed)
+            continue;
+
+        std::vector<ShaderPtr> stages;
+        for (auto& source : sources) {
+            auto& shader = shaders[{ source.type, source.code }];
+            if (!shader)
+                shader = Shader::CreateDeferred(source);
+            stages.push_back(shader);
+        }
+        // 이전 reload는 결과를 기다리지 않고 버림
+        entry.reload = Program::CreateDeferred(stages);
+        entry.reloadSources = std::move(sources);
+        count++;
+    }
+    return count;
+}
+
+void ProgramBatch::FinishReload(size_t slot) {
+    auto& entry = m_entries[slot];
+    auto program = std::move(entry.reload);
+    auto sources = std::move(entry.reloadSources);
+    if (!program->FinishLink()) {
+        SPDLOG_WARN("shader reload failed, keeping the previous program");
+        return;
+    }
+    SPDLOG_INFO("reloaded program {}", program->Get());
+    entry.program = std::move(program);
+    entry.sources = std::move(sources);
+    entry.state = State::Ready;
+    if (m_cache)
+        m_cache->Store(entry.sources, entry.program.get());
+}
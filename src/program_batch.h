@@ -0,0 +1,64 @@
+#ifndef __PROGRAM_BATCH_H__
+#define __PROGRAM_BATCH_H__
+
+#include "common.h"
+#include "program.h"
+#include "program_cache.h"
+#include <map>
+
+// compiles a set of programs without stalling on each one: Submit issues
+// every glCompileShader / glLinkProgram up front and the results are only
+// checked when a program is first asked for. with KHR/ARB_parallel_shader_compile
+// the driver compiles on its own threads and Get never blocks; without it Get
+// waits for a fence issued after each link (see Program::IsLinkComplete).
+// callers draw with a fallback program while Get returns nullptr
+CLASS_PTR(ProgramBatch)
+class ProgramBatch {
+public:
+    // cache may be null. hits are ready immediately, misses are stored
+    // once linked
+    static ProgramBatchUPtr Create(ProgramCache* cache = nullptr);
+
+    // queues (filename, type) stages, each preprocessed with the given
+    // defines; returns the slot for Get
+    size_t Add(const std::vector<std::pair<std::string, GLenum>>& files,
+        const std::vector<std::string>& defines = {});
+    // loads the sources and issues all compiles and links
+    void Submit();
+
+    // the linked program, or nullptr while still compiling (or if it failed)
+    Program* Get(size_t slot);
+    // blocks until the link result is known
+    Program* Wait(size_t slot);
+    bool IsPending(size_t slot) const;
+    bool IsFailed(size_t slot) const;
+
+    // relinks every program that uses one of the files (filename -> new
+    // source), directly or through #include, in the background. Get keeps
+    // returning the current program until the new one reports completion
+    // (same polling as the first link), and a failed relink keeps the old one.
+    // returns the number of programs being relinked
+    size_t Reload(const std::map<std::string, std::string>& files);
+
+private:
+    ProgramBatch() {}
+    bool Init(ProgramCache* cache);
+    void Finish(size_t slot);
+    void FinishReload(size_t slot);
+
+    enum class State { Queued, Pending, Ready, Failed };
+    struct Entry {
+        std::vector<std::pair<std::string, GLenum>> files;
+        std::vector<std::string> defines;
+        std::vector<ShaderSource> sources;
+        ProgramUPtr program;
+        State state { State::Queued };
+        // relink in flight, swapped in by FinishReload
+        std::vector<ShaderSource> reloadSources;
+        ProgramUPtr reload;
+    };
+    ProgramCache* m_cache { nullptr };
+    std::vector<Entry> m_entries;
+};
+
+#endif // __PROGRAM_BATCH_H__
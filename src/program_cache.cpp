@@ -0,0 +1,148 @@
+#include "program_cache.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+// file = header + binary blob
+struct ProgramBinaryHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t size;
+};
+static const char kBinaryMagic[4] = { 'P', 'B', 'I', 'N' };
+static const uint32_t kBinaryVersion = 1;
+
+// 64-bit FNV-1a, chained over several strings
+static uint64_t Hash64(const std::string& text, uint64_t value = 14695981039346656037ull) {
+    for (unsigned char c : text)
+        value = (value ^ c) * 1099511628211ull;
+    return value;
+}
+
+ProgramCacheUPtr ProgramCache::Create(const std::string& directory) {
+    auto cache = ProgramCacheUPtr(new ProgramCache());
+    if (!cache->Init(directory))
+        return nullptr;
+    return std::move(cache);
+}
+
+bool ProgramCache::Init(const std::string& directory) {
+    m_directory = directory;
+    auto getString = [](GLenum name) {
+        auto text = (const char*)glGetString(name);
+        return std::string(text ? text : "");
+    };
+    m_driver = getString(GL_VENDOR) + "\n" + getString(GL_RENDERER) + "\n" + getString(GL_VERSION);
+
+    // 지원하지 않으면 캐시 없이 항상 컴파일
+    m_enabled = Program::IsBinarySupported();
+    if (!m_enabled) {
+        SPDLOG_INFO("program binary not supported, shader cache disabled");
+        return true;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    if (error) {
+        SPDLOG_WARN("failed to create shader cache directory {}: {}", m_directory, error.message());
+        m_enabled = false;
+    }
+    return true;
+}
+
+uint64_t ProgramCache::GetKey(const std::vector<ShaderSource>& sources) const {
+    uint64_t key = Hash64(m_driver);
+    for (auto& source : sources) {
+        key = Hash64(std::to_string(source.type), key);
+        key = Hash64(source.code, key);
+    }
+    return key;
+}
+
+std::string ProgramCache::GetPath(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return m_directory + "/" + name;
+}
+
+ProgramUPtr ProgramCache::Find(const std::vector<ShaderSource>& sources) {
+    auto start = std::chrono::steady_clock::now();
+    ProgramUPtr program;
+    if (m_enabled)
+        program = LoadBinary(GetKey(sources));
+    if (program)
+        m_stats.hits++;
+    else
+        m_stats.misses++;
+
+    auto end = std::chrono::steady_clock::now();
+    m_stats.loadMs += std::chrono::duration<double, std::milli>(end - start).count();
+    return std::move(program);
+}
+
+void ProgramCache::Store(const std::vector<ShaderSource>& sources, const Program* program) {
+    if (m_enabled)
+        StoreBinary(GetKey(sources), program);
+}
+
+ProgramUPtr ProgramCache::LoadBinary(uint64_t key) {
+    std::string path = GetPath(key);
+    std::ifstream fin(path, std::ios::binary);
+    if (!fin.is_open())
+        return nullptr;
+
+    ProgramBinaryHeader header;
+    if (!fin.read((char*)&header, sizeof(header)) ||
+        memcmp(header.magic, kBinaryMagic, sizeof(kBinaryMagic)) != 0 ||
+        header.version != kBinaryVersion || header.key != key) {
+        SPDLOG_WARN("ignoring invalid shader cache file {}", path);
+        return nullptr;
+    }
+    std::vector<uint8_t> blob(header.size);
+    if (!fin.read((char*)blob.data(), blob.size()))
+        return nullptr;
+    fin.close();
+
+    auto program = Program::CreateFromBinary(header.format, blob.data(), blob.size());
+    if (!program) {
+        // 드라이버가 거부하면 지우고 소스에서 다시 만들어 저장
+        m_stats.rejected++;
+        SPDLOG_INFO("driver rejected cached program {}, recompiling", path);
+        std::error_code error;
+        std::filesystem::remove(path, error);
+    }
+    return std::move(program);
+}
+
+void ProgramCache::StoreBinary(uint64_t key, const Program* program) {
+    uint32_t format = 0;
+    std::vector<uint8_t> blob;
+    if (!program->GetBinary(&format, &blob))
+        return;
+
+    ProgramBinaryHeader header;
+    memcpy(header.magic, kBinaryMagic, sizeof(kBinaryMagic));
+    header.version = kBinaryVersion;
+    header.key = key;
+    header.format = format;
+    header.size = (uint32_t)blob.size();
+
+    // 쓰는 도중 종료되어도 깨진 파일이 남지 않게 임시 파일 후 이름 변경
+    std::string path = GetPath(key);
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream fout(temp, std::ios::binary | std::ios::trunc);
+        if (!fout.is_open())
+            return;
+        fout.write((const char*)&header, sizeof(header));
+        fout.write((const char*)blob.data(), blob.size());
+        if (!fout)
+            return;
+    }
+    std::error_code error;
+    std::filesystem::rename(temp, path, error);
+    if (error)
+        SPDLOG_WARN("failed to store shader cache file {}: {}", path, error.message());
+}
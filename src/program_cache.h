@@ -0,0 +1,45 @@
+#ifndef __PROGRAM_CACHE_H__
+#define __PROGRAM_CACHE_H__
+
+#include "common.h"
+#include "program.h"
+#include "shader.h"
+
+// on-disk cache of linked program binaries. the key hashes every stage's
+// source together with GL vendor / renderer / version, so editing a
+// shader or updating the driver just misses instead of loading a stale
+// binary. any failure falls back to compiling from source.
+CLASS_PTR(ProgramCache)
+class ProgramCache {
+public:
+    struct Stats {
+        uint32_t hits { 0 };
+        uint32_t misses { 0 };
+        uint32_t rejected { 0 };  // blob found but refused by the driver
+        double loadMs { 0.0 };    // total time spent in Find
+    };
+
+    static ProgramCacheUPtr Create(const std::string& directory = "./cache");
+
+    // compiling on a miss is up to the caller (ProgramBatch), which then
+    // stores the linked program. Find returns nullptr on a miss
+    ProgramUPtr Find(const std::vector<ShaderSource>& sources);
+    void Store(const std::vector<ShaderSource>& sources, const Program* program);
+
+    const Stats& GetStats() const { return m_stats; }
+
+private:
+    ProgramCache() {}
+    bool Init(const std::string& directory);
+    uint64_t GetKey(const std::vector<ShaderSource>& sources) const;
+    std::string GetPath(uint64_t key) const;
+    ProgramUPtr LoadBinary(uint64_t key);
+    void StoreBinary(uint64_t key, const Program* program);
+
+    std::string m_directory;
+    std::string m_driver;  // vendor / renderer / version
+    bool m_enabled { false };
+    Stats m_stats;
+};
+
+#endif // __PROGRAM_CACHE_H__
@@ -0,0 +1,36 @@
+#include "program_variants.h"
+
+ProgramVariantsUPtr ProgramVariants::Create(ProgramBatch* batch,
+    const std::vector<std::pair<std::string, GLenum>>& files) {
+    auto variants = ProgramVariantsUPtr(new ProgramVariants());
+    if (!variants->Init(batch, files))
+        return nullptr;
+    return std::move(variants);
+}
+
+bool ProgramVariants::Init(ProgramBatch* batch,
+    const std::vector<std::pair<std::string, GLenum>>& files) {
+    m_batch = batch;
+    m_files = files;
+    return true;
+}
+
+size_t ProgramVariants::GetSlot(uint32_t features) {
+    auto slot = m_slots.find(features);
+    if (slot != m_slots.end())
+        return slot->second;
+    // 처음 쓰이는 조합: batch에 추가하고 바로 컴파일 요청 (기다리지 않음)
+    size_t index = m_batch->Add(m_files, GetShaderFeatureDefines(features));
+    m_batch->Submit();
+    m_slots[features] = index;
+    SPDLOG_INFO("compiling shader variant {:#x} of {}", features, m_files.front().first);
+    return index;
+}
+
+Program* ProgramVariants::Get(uint32_t features) {
+    return m_batch->Get(GetSlot(features));
+}
+
+Program* ProgramVariants::Wait(uint32_t features) {
+    return m_batch->Wait(GetSlot(features));
+}
@@ -0,0 +1,33 @@
+#ifndef __PROGRAM_VARIANTS_H__
+#define __PROGRAM_VARIANTS_H__
+
+#include "common.h"
+#include "program_batch.h"
+#include <unordered_map>
+
+// one program per ShaderFeature bitmask over the same shader files. a
+// variant is queued on the batch the first time it is asked for, so only
+// the combinations actually drawn get compiled
+CLASS_PTR(ProgramVariants)
+class ProgramVariants {
+public:
+    static ProgramVariantsUPtr Create(ProgramBatch* batch,
+        const std::vector<std::pair<std::string, GLenum>>& files);
+
+    // nullptr while the variant is compiling (draw with a fallback)
+    Program* Get(uint32_t features);
+    // blocks until the variant is linked
+    Program* Wait(uint32_t features);
+    size_t GetVariantCount() const { return m_slots.size(); }
+
+private:
+    ProgramVariants() {}
+    bool Init(ProgramBatch* batch, const std::vector<std::pair<std::string, GLenum>>& files);
+    size_t GetSlot(uint32_t features);
+
+    ProgramBatch* m_batch { nullptr };
+    std::vector<std::pair<std::string, GLenum>> m_files;
+    std::unordered_map<uint32_t, size_t> m_slots;
+};
+
+#endif // __PROGRAM_VARIANTS_H__
@@ -0,0 +1,156 @@
+#include "ring.h"
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define RING_USE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RING_USE_SSE2 1
+#endif
+
+static const double kPi = 3.14159265358979323846;
+
+// the rotation recurrence is re-seeded with exact values every
+// kReseedBlocks steps so float error stays around 1e-6
+static const int kReseedBlocks = 16;
+
+static void ComputeSinCosScalar(double start, double step, int begin, int count,
+    float* sinOut, float* cosOut) {
+    for (int i = begin; i < count; i++) {
+        double angle = start + step * i;
+        sinOut[i] = (float)std::sin(angle);
+        cosOut[i] = (float)std::cos(angle);
+    }
+}
+
+#if RING_USE_AVX2
+static int ComputeSinCosAvx2(double start, double step, int count,
+    float* sinOut, float* cosOut) {
+    const int lanes = 8;
+    int blockCount = count / lanes;
+    __m256 rotCos = _mm256_set1_ps((float)std::cos(step * lanes));
+    __m256 rotSin = _mm256_set1_ps((float)std::sin(step * lanes));
+    __m256 s = _mm256_setzero_ps(), c = _mm256_setzero_ps();
+    for (int block = 0; block < blockCount; block++) {
+        int base = block * lanes;
+        if (block % kReseedBlocks == 0) {
+            ComputeSinCosScalar(start, step, base, base + lanes, sinOut, cosOut);
+            s = _mm256_loadu_ps(sinOut + base);
+            c = _mm256_loadu_ps(cosOut + base);
+            continue;
+        }
+        __m256 nextC = _mm256_fmsub_ps(c, rotCos, _mm256_mul_ps(s, rotSin));
+        __m256 nextS = _mm256_fmadd_ps(s, rotCos, _mm256_mul_ps(c, rotSin));
+        c = nextC;
+        s = nextS;
+        _mm256_storeu_ps(sinOut + base, s);
+        _mm256_storeu_ps(cosOut + base, c);
+    }
+    return blockCount * lanes;
+}
+#elif RING_USE_SSE2
+static int ComputeSinCosSse2(double start, double step, int count,
+    float* sinOut, float* cosOut) {
+    const int lanes = 4;
+    int blockCount = count / lanes;
+    __m128 rotCos = _mm_set1_ps((float)std::cos(step * lanes));
+    __m128 rotSin = _mm_set1_ps((float)std::sin(step * lanes));
+    __m128 s = _mm_setzero_ps(), c = _mm_setzero_ps();
+    for (int block = 0; block < blockCount; block++) {
+        int base = block * lanes;
+        if (block % kReseedBlocks == 0) {
+            ComputeSinCosScalar(start, step, base, base + lanes, sinOut, cosOut);
+            s = _mm_loadu_ps(sinOut + base);
+            c = _mm_loadu_ps(cosOut + base);
+            continue;
+        }
+        __m128 nextC = _mm_sub_ps(_mm_mul_ps(c, rotCos), _mm_mul_ps(s, rotSin));
+        __m128 nextS = _mm_add_ps(_mm_mul_ps(s, rotCos), _mm_mul_ps(c, rotSin));
+        c = nextC;
+        s = nextS;
+        _mm_storeu_ps(sinOut + base, s);
+        _mm_storeu_ps(cosOut + base, c);
+    }
+    return blockCount * lanes;
+}
+#endif
+
+void ComputeSinCos(double start, double step, int count, float* sinOut, float* cosOut) {
+    int done = 0;
+#if RING_USE_AVX2
+    done = ComputeSinCosAvx2(start, step, count, sinOut, cosOut);
+#elif RING_USE_SSE2
+    done = ComputeSinCosSse2(start, step, count, sinOut, cosOut);
+#endif
+    ComputeSinCosScalar(start, step, done, count, sinOut, cosOut);
+}
+
+SinCosTable MakeCircleTable(int segment) {
+    SinCosTable table;
+    table.sin.resize(segment + 1);
+    table.cos.resize(segment + 1);
+    ComputeSinCos(0.0, 2.0 * kPi / segment, segment, table.sin.data(), table.cos.data());
+    table.sin[segment] = table.sin[0];
+    table.cos[segment] = table.cos[0];
+    return table;
+}
+
+#if RING_USE_SSE2
+// (x0 x1 x2 x3) (y0 ..) (z0 ..) -> x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3
+static inline void StoreInterleaved3(float* out, __m128 x, __m128 y, __m128 z) {
+    __m128 xyLo = _mm_unpacklo_ps(x, y);
+    __m128 xyHi = _mm_unpackhi_ps(x, y);
+    __m128 zx = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+    __m128 yz = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+    __m128 zHi = _mm_shuffle_ps(z, xyHi, _MM_SHUFFLE(2, 2, 2, 2));
+    __m128 yzHi = _mm_shuffle_ps(xyHi, z, _MM_SHUFFLE(3, 3, 3, 3));
+    _mm_storeu_ps(out + 0, _mm_shuffle_ps(xyLo, zx, _MM_SHUFFLE(2, 0, 1, 0)));
+    _mm_storeu_ps(out + 4, _mm_shuffle_ps(yz, xyHi, _MM_SHUFFLE(1, 0, 2, 0)));
+    _mm_storeu_ps(out + 8, _mm_shuffle_ps(zHi, yzHi, _MM_SHUFFLE(2, 0, 2, 0)));
+}
+#endif
+
+void EmitRing(const SinCosTable& table, int first, int count, float radius, float axial,
+    RingAxis axis, float* out) {
+    if (first + count > table.GetCount())
+        count = table.GetCount() - first;
+    const float* sinTable = table.sin.data() + first;
+    const float* cosTable = table.cos.data() + first;
+    int i = 0;
+#if RING_USE_SSE2
+    __m128 r = _mm_set1_ps(radius);
+    __m128 a = _mm_set1_ps(axial);
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_mul_ps(_mm_loadu_ps(cosTable + i), r);
+        __m128 s = _mm_mul_ps(_mm_loadu_ps(sinTable + i), r);
+        if (axis == RingAxis::Y)
+            StoreInterleaved3(out + i * 3, x, a, s);
+        else
+            StoreInterleaved3(out + i * 3, x, s, a);
+    }
+#endif
+    for (; i < count; i++) {
+        float* v = out + i * 3;
+        v[0] = cosTable[i] * radius;
+        if (axis == RingAxis::Y) {
+            v[1] = axial;
+            v[2] = sinTable[i] * radius;
+        }
+        else {
+            v[1] = sinTable[i] * radius;
+            v[2] = axial;
+        }
+    }
+}
+
+const char* GetRingSimdPath() {
+#if RING_USE_AVX2
+    return "avx2";
+#elif RING_USE_SSE2
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
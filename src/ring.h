@@ -0,0 +1,36 @@
+#ifndef __RING_H__
+#define __RING_H__
+
+#include <vector>
+
+// Trig tables and ring emission shared by the round primitives.
+// Angles that repeat on every stack / cap are evaluated once and the
+// rings are produced by scaling the table (SSE/AVX2 when available).
+
+// sin/cos of (start + i * step) for i in [0, count)
+void ComputeSinCos(double start, double step, int count, float* sinOut, float* cosOut);
+
+struct SinCosTable {
+    std::vector<float> sin;
+    std::vector<float> cos;
+    int GetCount() const { return (int)sin.size(); }
+};
+
+// segment + 1 entries around the full circle, the last one is an exact
+// copy of the first so uv seam vertices land on the same position
+SinCosTable MakeCircleTable(int segment);
+
+enum class RingAxis {
+    Y,  // (cos * radius, axial, sin * radius)
+    Z,  // (cos * radius, sin * radius, axial)
+};
+
+// writes interleaved xyz triples for table entries [first, first + count)
+// to out (out points at the triple of entry first)
+void EmitRing(const SinCosTable& table, int first, int count, float radius, float axial,
+    RingAxis axis, float* out);
+
+// name of the code path selected at compile time ("avx2", "sse2", "scalar")
+const char* GetRingSimdPath();
+
+#endif // __RING_H__
@@ -1,9 +1,86 @@
 #include "shader.h"
+#include <sstream>
 
-ShaderUPtr Shader::CreateFromFile(const std::string& filename, GLenum shaderType) {
+std::vector<std::string> GetShaderFeatureDefines(uint32_t features) {
+    static const std::pair<uint32_t, const char*> kNames[] = {
+        { kShaderFeatureDetailTexture, "DETAIL_TEXTURE" },
+        { kShaderFeatureNormalView, "NORMAL_VIEW" },
+        { kShaderFeatureAtlas, "ATLAS" },
+    };
+    std::vector<std::string> defines;
+    for (auto& name : kNames) {
+        if (features & name.first)
+            defines.push_back(name.second);
+    }
+    return defines;
+}
+
+static std::string GetDirectory(const std::string& filename) {
+    auto slash = filename.find_last_of('/');
+    return slash == std::string::npos ? std::string() : filename.substr(0, slash + 1);
+}
+
+// filename의 내용을 out에 붙이면서 #include를 재귀적으로 펼침.
+// 에러 메시지의 "소스 번호:줄" 이 원래 파일을 가리키도록 #line을 넣음
+static bool Preprocess(ShaderSource& source, const std::string& filename, int sourceNumber,
+    const ShaderSource::FileReader& reader, std::string& out) {
+    auto text = reader(filename);
+    if (!text.has_value())
+        return false;
+    source.files[filename] = text.value();
+
+    std::istringstream lines(text.value());
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        auto start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line.compare(start, 8, "#include") != 0) {
+            out += line;
+            out += '\n';
+            // defines는 #version 바로 다음 줄에 (main 파일만)
+            if (sourceNumber == 0 && line.compare(0, 8, "#version") == 0 && !source.defines.empty()) {
+                for (auto& define : source.defines)
+                    out += "#define " + define + "\n";
+                out += "#line " + std::to_string(lineNumber + 1) + " 0\n";
+            }
+            continue;
+        }
+
+        auto open = line.find('"', start);
+        auto close = open == std::string::npos ? open : line.find('"', open + 1);
+        if (close == std::string::npos) {
+            SPDLOG_ERROR("{}:{}: malformed #include", filename, lineNumber);
+            return false;
+        }
+        std::string include = GetDirectory(filename) + line.substr(open + 1, close - open - 1);
+        // 이미 포함된 파일은 다시 넣지 않음 (include guard 불필요, 순환도 방지)
+        if (include == source.filename || source.files.count(include))
+            continue;
+        source.includes.push_back(include);
+        int includeNumber = (int)source.includes.size();
+        out += "#line 1 " + std::to_string(includeNumber) + "\n";
+        if (!Preprocess(source, include, includeNumber, reader, out))
+            return false;
+        out += "#line " + std::to_string(lineNumber + 1) + " " + std::to_string(sourceNumber) + "\n";
+    }
+    return true;
+}
+
+std::optional<ShaderSource> ShaderSource::Load(const std::string& filename, GLenum type,
+    const std::vector<std::string>& defines, const FileReader& reader) {
+    ShaderSource source;
+    source.filename = filename;
+    source.type = type;
+    source.defines = defines;
+    if (!Preprocess(source, filename, 0, reader, source.code))
+        return {};
+    return source;
+}
+
+ShaderUPtr Shader::CreateDeferred(const ShaderSource& source) {
     auto shader = ShaderUPtr(new Shader());
-    if (!shader->LoadFile(filename, shaderType))
-        return nullptr;
+    shader->Submit(source);
     return std::move(shader);
 }
 
@@ -13,28 +90,30 @@ Shader::~Shader() {
     }
 }
 
-bool Shader::LoadFile(const std::string& filename, GLenum shaderType) {
-    auto result = LoadTextFile(filename);
-    if (!result.has_value())
-        return false;
-
-    auto& code = result.value();
-    const char* codePtr = code.c_str();
-    int32_t codeLength = (int32_t)code.length();
+void Shader::Submit(const ShaderSource& source) {
+    const char* codePtr = source.code.c_str();
+    int32_t codeLength = (int32_t)source.code.length();
+    m_filename = source.filename;
+    m_includes = source.includes;
 
     // create and compile shader
-    m_shader = glCreateShader(shaderType);
+    m_shader = glCreateShader(source.type);
     glShaderSource(m_shader, 1, (const GLchar* const*)&codePtr, &codeLength);
     glCompileShader(m_shader);
+}
 
+bool Shader::CheckCompileStatus() const {
   // check compile error
     int success = 0;
     glGetShaderiv(m_shader, GL_COMPILE_STATUS, &success);
     if (!success) {
         char infoLog[1024];
         glGetShaderInfoLog(m_shader, 1024, nullptr, infoLog);
-        SPDLOG_ERROR("failed to compile shader: \"{}\"", filename);
+        SPDLOG_ERROR("failed to compile shader: \"{}\"", m_filename);
         SPDLOG_ERROR("reason: {}", infoLog);
+        // 에러 위치의 소스 번호 n은 n번째 include 파일 (0은 자기 자신)
+        for (size_t i = 0; i < m_includes.size(); i++)
+            SPDLOG_ERROR("source {}: {}", i + 1, m_includes[i]);
         return false;
     }
     return true;
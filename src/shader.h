@@ -2,17 +2,56 @@
 #define __SHADER_H__
 
 #include "common.h"
+#include <functional>
+#include <map>
+#include <vector>
+
+// optional features compiled into a shader as "#define <name>" right after
+// #version. a program variant is identified by the bitmask of its features
+enum ShaderFeature : uint32_t {
+    kShaderFeatureDetailTexture = 1 << 0,  // DETAIL_TEXTURE: blend tex2 over tex
+    kShaderFeatureNormalView = 1 << 1,     // NORMAL_VIEW: output normals, no texture fetch
+    kShaderFeatureAtlas = 1 << 2,          // ATLAS: map texCoord into atlasRegion of tex
+};
+std::vector<std::string> GetShaderFeatureDefines(uint32_t features);
+
+// source text of one stage after preprocessing (#include resolved, defines
+// injected), loaded once and used both for compiling and for the program
+// cache key
+struct ShaderSource {
+    using FileReader = std::function<std::optional<std::string>(const std::string&)>;
+
+    std::string filename;
+    GLenum type { 0 };
+    std::vector<std::string> defines;
+    std::string code;
+    // raw text of the file and of everything it includes, by path. the
+    // #line source number of includes[i] is i + 1
+    std::map<std::string, std::string> files;
+    std::vector<std::string> includes;
+
+    // #include "name" is resolved relative to the including file and pulled
+    // in once. reader defaults to reading from disk
+    static std::optional<ShaderSource> Load(const std::string& filename, GLenum type,
+        const std::vector<std::string>& defines = {}, const FileReader& reader = LoadTextFile);
+};
 
 CLASS_PTR(Shader);
 class Shader {
 public:
-    static ShaderUPtr CreateFromFile(const std::string& filename, GLenum shaderType);
+    // issues glCompileShader without waiting for the result. the status is
+    // checked later by CheckCompileStatus (e.g. once the program is linked)
+    static ShaderUPtr CreateDeferred(const ShaderSource& source);
     ~Shader();
     uint32_t Get() const { return m_shader; }    
+    // blocks until compiled; logs the info log on failure
+    bool CheckCompileStatus() const;
 private:
     Shader() {}
-    bool LoadFile(const std::string& filename, GLenum shaderType);
+    void Submit(const ShaderSource& source);
     uint32_t m_shader { 0 };
+    std::string m_filename;
+    std::vector<std::string> m_includes;
 };
 
-#endif // __SHADER_H__
\ No newline at end of file
+#endif // __SHADER_H__
@@ -0,0 +1,106 @@
+#include "shader_watcher.h"
+#include <filesystem>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+ShaderWatcherUPtr ShaderWatcher::Create(const std::string& directory) {
+    auto watcher = ShaderWatcherUPtr(new ShaderWatcher());
+    if (!watcher->Init(directory))
+        return nullptr;
+    return std::move(watcher);
+}
+
+#ifdef __linux__
+
+ShaderWatcher::~ShaderWatcher() {
+    if (m_thread.joinable()) {
+        uint64_t value = 1;
+        if (write(m_wakeup, &value, sizeof(value)) < 0)
+            SPDLOG_WARN("failed to wake shader watcher");
+        m_thread.join();
+    }
+    if (m_inotify >= 0)
+        close(m_inotify);
+    if (m_wakeup >= 0)
+        close(m_wakeup);
+}
+
+bool ShaderWatcher::Init(const std::string& directory) {
+    m_directory = directory;
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    m_wakeup = eventfd(0, EFD_CLOEXEC);
+    if (m_inotify < 0 || m_wakeup < 0) {
+        SPDLOG_ERROR("failed to initialize inotify");
+        return false;
+    }
+    // 에디터는 보통 덮어쓰기(close_write)나 임시 파일 rename(moved_to)으로 저장
+    if (inotify_add_watch(m_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        SPDLOG_ERROR("failed to watch shader directory: {}", directory);
+        return false;
+    }
+    m_thread = std::thread([this] { WatchLoop(); });
+    SPDLOG_INFO("watching {} for shader changes", directory);
+    return true;
+}
+
+void ShaderWatcher::WatchLoop() {
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        pollfd fds[2] = {
+            { m_inotify, POLLIN, 0 },
+            { m_wakeup, POLLIN, 0 },
+        };
+        if (poll(fds, 2, -1) < 0)
+            continue;
+        if (fds[1].revents & POLLIN)
+            return;
+
+        // 한 번의 저장에 이벤트가 여러 개 올 수 있으므로 파일 이름으로 모음
+        std::vector<std::string> names;
+        ssize_t length;
+        while ((length = read(m_inotify, buffer, sizeof(buffer))) > 0) {
+            for (char* ptr = buffer; ptr < buffer + length; ) {
+                auto event = (const inotify_event*)ptr;
+                if (event->len > 0 && !(event->mask & IN_ISDIR))
+                    names.push_back(event->name);
+                ptr += sizeof(inotify_event) + event->len;
+            }
+        }
+        for (auto& name : names) {
+            // 에디터의 임시 파일은 읽기 전에 지워지기도 함
+            std::string filename = m_directory + "/" + name;
+            if (!std::filesystem::is_regular_file(filename))
+                continue;
+            auto code = LoadTextFile(filename);
+            if (!code.has_value())
+                continue;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_changes[filename] = std::move(code.value());
+        }
+    }
+}
+
+#else
+
+ShaderWatcher::~ShaderWatcher() {}
+
+bool ShaderWatcher::Init(const std::string& directory) {
+    SPDLOG_INFO("shader hot reload needs inotify, disabled on this platform");
+    return false;
+}
+
+void ShaderWatcher::WatchLoop() {}
+
+#endif
+
+std::map<std::string, std::string> ShaderWatcher::TakeChanges() {
+    std::map<std::string, std::string> changes;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    changes.swap(m_changes);
+    return changes;
+}
@@ -0,0 +1,36 @@
+#ifndef __SHADER_WATCHER_H__
+#define __SHADER_WATCHER_H__
+
+#include "common.h"
+#include <map>
+#include <mutex>
+#include <thread>
+
+// watches a shader directory with inotify on a background thread. changed
+// files are read on that thread too, so the render loop only picks up the
+// finished text. Create returns nullptr where inotify is not available
+// (hot reload is then simply off)
+CLASS_PTR(ShaderWatcher)
+class ShaderWatcher {
+public:
+    static ShaderWatcherUPtr Create(const std::string& directory);
+    ~ShaderWatcher();
+
+    // files changed since the last call, "<directory>/<name>" -> new source.
+    // never blocks on file io
+    std::map<std::string, std::string> TakeChanges();
+
+private:
+    ShaderWatcher() {}
+    bool Init(const std::string& directory);
+    void WatchLoop();
+
+    std::string m_directory;
+    int m_inotify { -1 };
+    int m_wakeup { -1 };  // eventfd, signaled to stop the thread
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::map<std::string, std::string> m_changes;
+};
+
+#endif // __SHADER_WATCHER_H__
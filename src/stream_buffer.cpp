@@ -0,0 +1,95 @@
+#include "stream_buffer.h"
+
+StreamBufferUPtr StreamBuffer::Create(uint32_t bufferType, size_t frameSize, int frameCount) {
+    auto buffer = StreamBufferUPtr(new StreamBuffer());
+    if (!buffer->Init(bufferType, frameSize, frameCount))
+        return nullptr;
+    return std::move(buffer);
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (auto fence : m_fences) {
+        if (fence)
+            glDeleteSync(fence);
+    }
+    if (m_persistent || m_mapped)
+        m_buffer->Unmap();
+}
+
+bool StreamBuffer::Init(uint32_t bufferType, size_t frameSize, int frameCount) {
+    m_frameSize = frameSize;
+    m_fences.resize(frameCount, nullptr);
+    size_t size = frameSize * frameCount;
+
+    const uint32_t flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    m_buffer = Buffer::CreateWithStorage(bufferType, flags, nullptr, size);
+    if (m_buffer) {
+        m_persistent = (uint8_t*)m_buffer->Map(0, size, flags);
+        if (m_persistent)
+            return true;
+        SPDLOG_ERROR("failed to map persistent stream buffer, falling back");
+    }
+
+    m_buffer = Buffer::CreateWithData(bufferType, GL_STREAM_DRAW, nullptr, size);
+    return m_buffer != nullptr;
+}
+
+void StreamBuffer::BeginFrame() {
+    m_used = 0;
+    GLsync& fence = m_fences[m_frame];
+    if (fence) {
+        // 대부분은 이미 끝나 있음, 아니면 persistent는 기다리고 나머지는 orphan
+        GLenum result = glClientWaitSync(fence, 0, 0);
+        if (result == GL_TIMEOUT_EXPIRED) {
+            m_stallCount++;
+            if (m_persistent) {
+                while (result == GL_TIMEOUT_EXPIRED)
+                    result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            }
+            else {
+                // 새 저장소를 받으면 이전 fence들은 의미가 없어짐
+                m_buffer->Orphan();
+                for (auto& other : m_fences) {
+                    if (other)
+                        glDeleteSync(other);
+                    other = nullptr;
+                }
+            }
+        }
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    if (m_persistent) {
+        m_mapped = m_persistent + GetRegionOffset();
+        return;
+    }
+    // 이 영역은 fence로 보호되므로 드라이버의 동기화는 필요 없음
+    m_mapped = (uint8_t*)m_buffer->Map(GetRegionOffset(), m_frameSize,
+        GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+}
+
+void* StreamBuffer::Allocate(size_t size, size_t alignment, size_t* offset) {
+    if (!m_mapped)
+        return nullptr;
+    size_t begin = (m_used + alignment - 1) / alignment * alignment;
+    if (begin + size > m_frameSize)
+        return nullptr;
+    m_used = begin + size;
+    *offset = GetRegionOffset() + begin;
+    return m_mapped + begin;
+}
+
+void StreamBuffer::FinishWrites() {
+    if (!m_persistent && m_mapped)
+        m_buffer->Unmap();
+    m_mapped = nullptr;
+}
+
+void StreamBuffer::EndFrame() {
+    FinishWrites();
+    m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_frame = (m_frame + 1) % (int)m_fences.size();
+}
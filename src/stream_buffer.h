@@ -0,0 +1,54 @@
+#ifndef __STREAM_BUFFER_H__
+#define __STREAM_BUFFER_H__
+
+#include "common.h"
+#include "buffer.h"
+#include <vector>
+
+// per-frame dynamic data (instances, uniforms, ...) in a ring of
+// frameCount regions, each guarded by a fence so the CPU never writes a
+// region the GPU may still read.
+// - ARB_buffer_storage: mapped once, persistent + coherent
+// - otherwise: each region is mapped unsynchronized; if the ring wraps
+//   onto a region that is still in flight the buffer is orphaned instead
+//   of waiting
+CLASS_PTR(StreamBuffer)
+class StreamBuffer {
+public:
+    static StreamBufferUPtr Create(uint32_t bufferType, size_t frameSize, int frameCount = 3);
+    ~StreamBuffer();
+
+    // per frame: BeginFrame, Allocate + write, FinishWrites, draws that
+    // read the data, EndFrame
+    void BeginFrame();
+    // unmaps the region on the fallback path (a buffer must not be drawn
+    // from while mapped without the persistent bit)
+    void FinishWrites();
+    void EndFrame();
+
+    // write pointer into the current frame's region and the byte offset
+    // of it inside GetBuffer(). nullptr when the region is full
+    void* Allocate(size_t size, size_t alignment, size_t* offset);
+
+    const Buffer* GetBuffer() const { return m_buffer.get(); }
+    bool IsPersistent() const { return m_persistent != nullptr; }
+    size_t GetFrameSize() const { return m_frameSize; }
+    // how often BeginFrame had to block on / orphan around a busy region
+    uint32_t GetStallCount() const { return m_stallCount; }
+
+private:
+    StreamBuffer() {}
+    bool Init(uint32_t bufferType, size_t frameSize, int frameCount);
+    size_t GetRegionOffset() const { return m_frameSize * m_frame; }
+
+    BufferUPtr m_buffer;
+    uint8_t* m_persistent { nullptr };  // whole buffer, persistent path only
+    uint8_t* m_mapped { nullptr };      // current region
+    std::vector<GLsync> m_fences;
+    size_t m_frameSize { 0 };
+    size_t m_used { 0 };
+    int m_frame { 0 };
+    uint32_t m_stallCount { 0 };
+};
+
+#endif // __STREAM_BUFFER_H__
@@ -1,4 +1,5 @@
 #include "texture.h"
+#include <algorithm>
 
 TextureUPtr Texture::CreateFromImage(const Image* image) {
     auto texture = TextureUPtr(new Texture());
@@ -7,6 +8,56 @@ TextureUPtr Texture::CreateFromImage(const Image* image) {
     return std::move(texture);
 }
 
+bool Texture::IsSrgbFramebuffer() {
+    static const bool srgb = [] {
+        // GLFW_SRGB_CAPABLE은 요청일 뿐이므로 실제 default framebuffer를 확인
+        GLint encoding = GL_LINEAR;
+        glGetFramebufferAttachmentParameteriv(GL_FRAMEBUFFER, GL_BACK_LEFT,
+            GL_FRAMEBUFFER_ATTACHMENT_COLOR_ENCODING, &encoding);
+        return encoding == GL_SRGB;
+    }();
+    return srgb;
+}
+
+// sRGB로 다시 인코딩되지 않으면 sRGB 텍스처는 어둡게 나오므로 linear 포맷으로
+static uint32_t ResolveInternalFormat(uint32_t internalFormat) {
+    if (Texture::IsSrgbFramebuffer())
+        return internalFormat;
+    switch (internalFormat) {
+        case GL_SRGB8: return GL_RGB8;
+        case GL_SRGB8_ALPHA8: return GL_RGBA8;
+        default: return internalFormat;
+    }
+}
+
+TextureUPtr Texture::Create(int width, int height, int levelCount, uint32_t internalFormat) {
+    auto texture = TextureUPtr(new Texture());
+    texture->CreateTexture();
+    internalFormat = ResolveInternalFormat(internalFormat);
+    for (int level = 0; level < levelCount; level++) {
+        glTexImage2D(GL_TEXTURE_2D, level, internalFormat,
+            std::max(width >> level, 1), std::max(height >> level, 1), 0,
+            GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    // 넘겨받은 레벨까지만 사용 (mip chain이 짧아도 완전한 텍스처)
+    if (levelCount > 1)
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+    return std::move(texture);
+}
+
+uint32_t Texture::GetImageInternalFormat(int channelCount) {
+    return channelCount >= 3 ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+}
+
+static GLenum GetImageFormat(int channelCount) {
+    switch (channelCount) {
+        case 1: return GL_RED;
+        case 2: return GL_RG;
+        case 3: return GL_RGB;
+        default: return GL_RGBA;
+    }
+}
+
 Texture::~Texture() {
     if (m_texture) {
         glDeleteTextures(1, &m_texture);
@@ -36,18 +87,29 @@ void Texture::CreateTexture() {
 }
 
 void Texture::SetTextureFromImage(const Image* image) {
-    GLenum format = GL_RGBA;
-    switch (image->GetChannelCount()) {
-        default: break;
-        case 1: format = GL_RED; break;
-        case 2: format = GL_RG; break;
-        case 3: format = GL_RGB; break;
-    }
+    GLenum format = GetImageFormat(image->GetChannelCount());
 
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA,
+    // 생성 후에도 불릴 수 있으므로 (비동기 로딩) 다시 bind
+    Bind();
+    // RGB 이미지는 한 줄이 4의 배수가 아닐 수 있음
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, ResolveInternalFormat(GetImageInternalFormat(image->GetChannelCount())),
         image->GetWidth(), image->GetHeight(), 0,
         format, GL_UNSIGNED_BYTE,
         image->GetData());
 
     glGenerateMipmap(GL_TEXTURE_2D);
+}
+
+void Texture::SetRows(int level, int y, int rowCount, int width, int channelCount,
+    int rowAlignment, const void* pixels) const {
+    Bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, rowAlignment);
+    glTexSubImage2D(GL_TEXTURE_2D, level, 0, y, width, rowCount,
+        GetImageFormat(channelCount), GL_UNSIGNED_BYTE, pixels);
+}
+
+void Texture::GenerateMipmap() const {
+    Bind();
+    glGenerateMipmap(GL_TEXTURE_2D);
 }
\ No newline at end of file
@@ -7,17 +7,38 @@ CLASS_PTR(Texture)
 class Texture {
 public:
     static TextureUPtr CreateFromImage(const Image* image);
+    // color images (3 or 4 channels) are sRGB encoded and get an sRGB
+    // format; 1 and 2 channel images are treated as linear data
+    static uint32_t GetImageInternalFormat(int channelCount);
+    // whether the default framebuffer encodes to sRGB. queried once, so the
+    // first call needs the window's context current with no FBO bound.
+    // without it sRGB formats are stored as their linear counterparts
+    // (sampling then returns the sRGB values unchanged, as written)
+    static bool IsSrgbFramebuffer();
+    // storage for levelCount mip levels, contents undefined (filled with SetRows).
+    // GL_SRGB8(_ALPHA8) falls back to GL_RGB8(A8) without an sRGB framebuffer
+    static TextureUPtr Create(int width, int height, int levelCount = 1,
+        uint32_t internalFormat = GL_RGBA8);
     ~Texture();
 
     const uint32_t Get() const { return m_texture; }
     void Bind() const;
     void SetFilter(uint32_t minFilter, uint32_t magFilter) const;
     void SetWrap(uint32_t sWrap, uint32_t tWrap) const;
+    // replaces the contents (and size) with image and rebuilds the mipmaps
+    void SetTextureFromImage(const Image* image);
+    // uploads rows [y, y + rowCount) of a mip level, each row padded to
+    // rowAlignment bytes. with a GL_PIXEL_UNPACK_BUFFER bound, pixels is a
+    // byte offset into it
+    void SetRows(int level, int y, int rowCount, int width, int channelCount,
+        int rowAlignment, const void* pixels) const;
+    void GenerateMipmap() const;
+    // exchanges the GL objects, e.g. to replace a placeholder in place
+    void Swap(Texture& other) { std::swap(m_texture, other.m_texture); }
 
 private:
     Texture() {}
     void CreateTexture();
-    void SetTextureFromImage(const Image* image);
 
     uint32_t m_texture { 0 };
 };
@@ -0,0 +1,131 @@
+#include "texture_atlas.h"
+#include "image_kernels.h"
+#include <algorithm>
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include <imstb_rectpack.h>
+
+TextureAtlasUPtr TextureAtlas::Create(const std::vector<const Image*>& images,
+    int padding, int maxImageSize, int maxSize) {
+    auto atlas = TextureAtlasUPtr(new TextureAtlas());
+    if (!atlas->Init(images, padding, maxImageSize, maxSize))
+        return nullptr;
+    return std::move(atlas);
+}
+
+// RGBA로 변환하면서 maxImageSize보다 크면 반씩 줄임 (color 이미지만)
+static std::vector<uint8_t> GetRGBAPixels(const Image* image, int maxImageSize, int& width, int& height) {
+    width = image->GetWidth();
+    height = image->GetHeight();
+    size_t pixelCount = (size_t)width * height;
+    const uint8_t* src = image->GetData();
+    std::vector<uint8_t> pixels(pixelCount * 4);
+    if (image->GetChannelCount() == 4)
+        std::copy(src, src + pixelCount * 4, pixels.begin());
+    else
+        ExpandRGBToRGBA(src, pixels.data(), pixelCount);
+    while (maxImageSize > 0 && std::max(width, height) > maxImageSize) {
+        std::vector<uint8_t> half((size_t)std::max(width / 2, 1) * std::max(height / 2, 1) * 4);
+        Downsample(pixels.data(), width, height, 4, half.data(), MipFilter::Box, true);
+        pixels.swap(half);
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+    return pixels;
+}
+
+bool TextureAtlas::Init(const std::vector<const Image*>& images, int padding, int maxImageSize, int maxSize) {
+    // level k의 gutter는 padding >> k 텍셀, 1 텍셀이 남는 level까지만 사용
+    m_levelCount = 1;
+    while ((padding >> m_levelCount) > 0)
+        m_levelCount++;
+    // 모든 칸을 가장 작은 level의 1 텍셀 단위로 맞춰서 2x2 평균이 이웃 칸을 섞지 않게 함
+    const int cell = 1 << (m_levelCount - 1);
+
+    std::vector<std::vector<uint8_t>> pixels(images.size());
+    std::vector<stbrp_rect> rects(images.size());
+    m_regions.resize(images.size());
+    size_t cellArea = 0;
+    int minGrid = 1;
+    // atlas는 sRGB color 텍스처이므로 linear 데이터(1, 2 채널)는 따로 로드해야 함
+    for (size_t i = 0; i < images.size(); i++) {
+        int channelCount = images[i]->GetChannelCount();
+        if (channelCount < 3) {
+            SPDLOG_ERROR("atlas image {} has {} channels, only color images can be packed",
+                i, channelCount);
+            return false;
+        }
+    }
+    for (size_t i = 0; i < images.size(); i++) {
+        auto& region = m_regions[i];
+        pixels[i] = GetRGBAPixels(images[i], maxImageSize, region.width, region.height);
+        rects[i] = {};
+        rects[i].id = (int)i;
+        rects[i].w = (region.width + padding * 2 + cell - 1) / cell;
+        rects[i].h = (region.height + padding * 2 + cell - 1) / cell;
+        cellArea += (size_t)rects[i].w * rects[i].h;
+        minGrid = std::max(minGrid, std::max((int)rects[i].w, (int)rects[i].h));
+    }
+
+    // 넓이가 들어가는 가장 작은 2의 거듭제곱부터 시작해서 한 변씩 두 배로
+    int gridWidth = 1, gridHeight = 1;
+    while (gridWidth < minGrid || (size_t)gridWidth * gridWidth < cellArea)
+        gridWidth *= 2;
+    gridHeight = gridWidth;
+    std::vector<stbrp_node> nodes;
+    while (true) {
+        if (gridWidth * cell > maxSize || gridHeight * cell > maxSize) {
+            SPDLOG_ERROR("failed to pack {} images into a {}x{} atlas", images.size(), maxSize, maxSize);
+            return false;
+        }
+        nodes.resize(gridWidth);
+        stbrp_context context;
+        stbrp_init_target(&context, gridWidth, gridHeight, nodes.data(), (int)nodes.size());
+        if (stbrp_pack_rects(&context, rects.data(), (int)rects.size()))
+            break;
+        if (gridHeight < gridWidth)
+            gridHeight *= 2;
+        else
+            gridWidth *= 2;
+    }
+    m_width = gridWidth * cell;
+    m_height = gridHeight * cell;
+    m_levelCount = std::min(m_levelCount, GetMipLevelCount(m_width, m_height));
+
+    // 칸 전체를 채움: 이미지 밖은 가장자리 텍셀을 늘려서 (clamp)
+    std::vector<std::vector<uint8_t>> levels(m_levelCount);
+    levels[0].resize((size_t)m_width * m_height * 4);
+    auto texels = (uint32_t*)levels[0].data();
+    for (auto& rect : rects) {
+        auto& region = m_regions[rect.id];
+        auto src = (const uint32_t*)pixels[rect.id].data();
+        int left = rect.x * cell, bottom = rect.y * cell;
+        region.x = left + padding;
+        region.y = bottom + padding;
+        for (int y = 0; y < rect.h * cell; y++) {
+            int sy = std::min(std::max(y - padding, 0), region.height - 1);
+            uint32_t* out = texels + (size_t)(bottom + y) * m_width + left;
+            const uint32_t* row = src + (size_t)sy * region.width;
+            for (int x = 0; x < rect.w * cell; x++)
+                out[x] = row[std::min(std::max(x - padding, 0), region.width - 1)];
+        }
+        region.uvTransform = glm::vec4(
+            (float)region.width / m_width, (float)region.height / m_height,
+            (float)region.x / m_width, (float)region.y / m_height);
+        pixels[rect.id].clear();
+    }
+    auto levelSize = [](int size, int level) { return std::max(size >> level, 1); };
+    for (int i = 1; i < m_levelCount; i++) {
+        levels[i].resize((size_t)levelSize(m_width, i) * levelSize(m_height, i) * 4);
+        Downsample(levels[i - 1].data(), levelSize(m_width, i - 1), levelSize(m_height, i - 1), 4,
+            levels[i].data(), MipFilter::Box, true);
+    }
+
+    // mip은 linear light에서 만들었으므로 sRGB로 저장
+    m_texture = Texture::Create(m_width, m_height, m_levelCount, GL_SRGB8_ALPHA8);
+    if (!m_texture)
+        return false;
+    for (int i = 0; i < m_levelCount; i++)
+        m_texture->SetRows(i, 0, levelSize(m_height, i), levelSize(m_width, i), 4, 4, levels[i].data());
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef __TEXTURE_ATLAS_H__
+#define __TEXTURE_ATLAS_H__
+
+#include "common.h"
+#include "image.h"
+#include "texture.h"
+
+// many images packed into one RGBA texture (imstb_rectpack skyline), so
+// objects that differ only by texture can share a bind and a draw.
+// each image is surrounded by padding texels copied from its edges and
+// placed on a grid aligned to the smallest mip, so levels down to a one
+// texel gutter never mix neighbours. the mip chain stops there
+// (log2(padding) + 1 levels); repeat wrapping is not available in an atlas.
+// the atlas is an sRGB color texture (see Texture::GetImageInternalFormat),
+// so only 3 and 4 channel images are accepted; 1 and 2 channel images are
+// linear data and stay separate textures
+struct AtlasRegion {
+    int x, y, width, height;  // texels of level 0, without the padding
+    // texCoord * uvTransform.xy + uvTransform.zw maps [0, 1] into the region
+    glm::vec4 uvTransform;
+};
+
+CLASS_PTR(TextureAtlas)
+class TextureAtlas {
+public:
+    // regions are in the order of images. images larger than maxImageSize
+    // (0: no limit) are halved until they fit. nullptr if they do not fit in
+    // maxSize x maxSize or an image has fewer than 3 channels
+    static TextureAtlasUPtr Create(const std::vector<const Image*>& images,
+        int padding = 8, int maxImageSize = 0, int maxSize = 4096);
+
+    const Texture* GetTexture() const { return m_texture.get(); }
+    int GetWidth() const { return m_width; }
+    int GetHeight() const { return m_height; }
+    int GetLevelCount() const { return m_levelCount; }
+    size_t GetRegionCount() const { return m_regions.size(); }
+    const AtlasRegion& GetRegion(size_t index) const { return m_regions[index]; }
+
+private:
+    TextureAtlas() {}
+    bool Init(const std::vector<const Image*>& images, int padding, int maxImageSize, int maxSize);
+    TextureUPtr m_texture;
+    int m_width { 0 };
+    int m_height { 0 };
+    int m_levelCount { 0 };
+    std::vector<AtlasRegion> m_regions;
+};
+
+#endif // __TEXTURE_ATLAS_H__
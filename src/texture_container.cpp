@@ -0,0 +1,158 @@
+#include "texture_container.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char kMagic[4] = { 'C', 'T', 'E', 'X' };
+
+static size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+uint64_t TextureContainer::Hash(const void* data, size_t size, uint64_t seed) {
+    uint64_t value = seed;
+    auto bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++)
+        value = (value ^ bytes[i]) * 1099511628211ull;
+    return value;
+}
+
+std::unique_ptr<TextureContainer> TextureContainer::Open(const std::string& filename, bool prefetch) {
+    auto container = std::unique_ptr<TextureContainer>(new TextureContainer());
+    if (!container->Map(filename, prefetch))
+        return nullptr;
+
+    // 헤더와 레벨 테이블이 파일 안에 온전히 있는지 확인
+    const size_t tableOffset = sizeof(TextureContainerHeader);
+    if (container->m_size < tableOffset)
+        return nullptr;
+    auto& header = container->m_header;
+    memcpy(&header, container->m_data, sizeof(header));
+    if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.levelCount == 0 || header.levelCount > 32 ||
+        container->m_size < tableOffset + sizeof(TextureContainerLevel) * header.levelCount)
+        return nullptr;
+    container->m_levels.resize(header.levelCount);
+    memcpy(container->m_levels.data(), container->m_data + tableOffset,
+        sizeof(TextureContainerLevel) * header.levelCount);
+    for (auto& level : container->m_levels) {
+        if (level.offset + level.size > container->m_size ||
+            level.rowPitch * level.height > level.size)
+            return nullptr;
+    }
+    return container;
+}
+
+#ifndef _WIN32
+
+bool TextureContainer::Map(const std::string& filename, bool prefetch) {
+    int file = open(filename.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0) {
+        close(file);
+        return false;
+    }
+    m_size = (size_t)info.st_size;
+    // 매핑은 파일을 닫아도 유지됨
+    void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+        return false;
+    m_data = (const uint8_t*)data;
+
+    if (prefetch) {
+        // 읽기 요청을 한 번에 넣고, 페이지를 건드려서 끝날 때까지 기다림
+        madvise(data, m_size, MADV_WILLNEED);
+        volatile uint8_t sink = 0;
+        long pageSize = sysconf(_SC_PAGESIZE);
+        for (size_t offset = 0; offset < m_size; offset += pageSize)
+            sink = sink + m_data[offset];
+    }
+    return true;
+}
+
+TextureContainer::~TextureContainer() {
+    if (m_data && m_fileData.empty())
+        munmap((void*)m_data, m_size);
+}
+
+#else
+
+bool TextureContainer::Map(const std::string& filename, bool prefetch) {
+    std::ifstream fin(filename, std::ios::binary | std::ios::ate);
+    if (!fin.is_open())
+        return false;
+    m_fileData.resize((size_t)fin.tellg());
+    fin.seekg(0);
+    if (m_fileData.empty() || !fin.read((char*)m_fileData.data(), m_fileData.size()))
+        return false;
+    m_data = m_fileData.data();
+    m_size = m_fileData.size();
+    return true;
+}
+
+TextureContainer::~TextureContainer() {}
+
+#endif
+
+bool TextureContainer::Write(const std::string& filename, const TextureContainerHeader& source,
+    const std::vector<std::vector<uint8_t>>& levels) {
+    TextureContainerHeader header = source;
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.levelCount = (uint32_t)levels.size();
+    if (header.rowAlignment == 0)
+        header.rowAlignment = 1;
+
+    // 레벨 크기와 위치 계산
+    std::vector<TextureContainerLevel> table(levels.size());
+    size_t offset = AlignUp(sizeof(header) + sizeof(TextureContainerLevel) * levels.size(),
+        kTextureContainerDataAlignment);
+    for (size_t i = 0; i < levels.size(); i++) {
+        auto& level = table[i];
+        level.width = std::max(header.width >> i, 1u);
+        level.height = std::max(header.height >> i, 1u);
+        level.rowPitch = AlignUp((size_t)level.width * header.channelCount, header.rowAlignment);
+        level.offset = offset;
+        level.size = level.rowPitch * level.height;
+        if (levels[i].size() < (size_t)level.width * header.channelCount * level.height)
+            return false;
+        offset = AlignUp(offset + level.size, kTextureContainerDataAlignment);
+    }
+
+    // 쓰는 도중 실패해도 이전 파일이 깨지지 않게 임시 파일 후 이름 변경
+    std::string temp = filename + ".tmp";
+    {
+        std::ofstream fout(temp, std::ios::binary | std::ios::trunc);
+        if (!fout.is_open())
+            return false;
+        fout.write((const char*)&header, sizeof(header));
+        fout.write((const char*)table.data(), sizeof(TextureContainerLevel) * table.size());
+        std::vector<uint8_t> padding(std::max<size_t>(kTextureContainerDataAlignment, header.rowAlignment), 0);
+        size_t position = sizeof(header) + sizeof(TextureContainerLevel) * table.size();
+        for (size_t i = 0; i < levels.size(); i++) {
+            auto& level = table[i];
+            fout.write((const char*)padding.data(), level.offset - position);
+            size_t rowBytes = (size_t)level.width * header.channelCount;
+            for (uint32_t y = 0; y < level.height; y++) {
+                fout.write((const char*)levels[i].data() + rowBytes * y, rowBytes);
+                fout.write((const char*)padding.data(), level.rowPitch - rowBytes);
+            }
+            position = level.offset + level.size;
+        }
+        if (!fout)
+            return false;
+    }
+    std::remove(filename.c_str());
+    return std::rename(temp.c_str(), filename.c_str()) == 0;
+}
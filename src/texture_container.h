@@ -0,0 +1,86 @@
+#ifndef __TEXTURE_CONTAINER_H__
+#define __TEXTURE_CONTAINER_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Cooked texture file (tools/texture_cooker): final GL formats and every
+// mip level, ready to upload without decoding. Layout:
+//   TextureContainerHeader
+//   TextureContainerLevel[levelCount]
+//   level data, each starting at a kTextureContainerDataAlignment offset
+// rows inside a level are padded to rowAlignment (GL_UNPACK_ALIGNMENT).
+// Open memory-maps the file, so the pixel pointers point into the mapping
+
+// GL enum values, spelled out because this library has no GL headers
+static const uint32_t kTextureFormatR8 = 0x8229;      // GL_R8
+static const uint32_t kTextureFormatRG8 = 0x822B;     // GL_RG8
+static const uint32_t kTextureFormatRGB8 = 0x8051;    // GL_RGB8
+static const uint32_t kTextureFormatRGBA8 = 0x8058;   // GL_RGBA8
+// sRGB encoded color: sampling decodes to linear, matching mips that were
+// filtered in linear light
+static const uint32_t kTextureFormatSRGB8 = 0x8C41;         // GL_SRGB8
+static const uint32_t kTextureFormatSRGB8Alpha8 = 0x8C43;   // GL_SRGB8_ALPHA8
+static const size_t kTextureContainerDataAlignment = 64;
+
+struct TextureContainerHeader {
+    char magic[4];            // "CTEX"
+    uint32_t version;
+    uint32_t internalFormat;  // kTextureFormat*
+    uint32_t channelCount;    // pixel data format follows: 1 red, 2 rg, 3 rgb, 4 rgba
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+    uint32_t rowAlignment;    // 1, 2, 4 or 8
+    uint64_t contentHash;     // FNV-1a of the source image file and cook settings
+};
+
+struct TextureContainerLevel {
+    uint32_t width;
+    uint32_t height;
+    uint64_t rowPitch;
+    uint64_t offset;          // from the start of the file
+    uint64_t size;
+};
+
+class TextureContainer {
+public:
+    static const uint32_t kVersion = 2;
+
+    // nullptr if the file is missing, truncated or from another version
+    // (nothing is logged, the caller decides whether that is an error).
+    // prefetch asks the OS to read the whole file in now (call it off the
+    // render thread) so uploads do not fault pages in later
+    static std::unique_ptr<TextureContainer> Open(const std::string& filename, bool prefetch = false);
+    // level data is tightly packed rows (width * channelCount); rows are
+    // padded to rowAlignment in the file
+    static bool Write(const std::string& filename, const TextureContainerHeader& header,
+        const std::vector<std::vector<uint8_t>>& levels);
+    // 64-bit FNV-1a. pass a previous result as seed to hash several buffers
+    static const uint64_t kHashSeed = 14695981039346656037ull;
+    static uint64_t Hash(const void* data, size_t size, uint64_t seed = kHashSeed);
+
+    ~TextureContainer();
+    TextureContainer(const TextureContainer&) = delete;
+    TextureContainer& operator=(const TextureContainer&) = delete;
+
+    const TextureContainerHeader& GetHeader() const { return m_header; }
+    const TextureContainerLevel& GetLevel(int level) const { return m_levels[level]; }
+    const uint8_t* GetLevelData(int level) const { return m_data + m_levels[level].offset; }
+
+private:
+    TextureContainer() {}
+    bool Map(const std::string& filename, bool prefetch);
+
+    TextureContainerHeader m_header {};
+    std::vector<TextureContainerLevel> m_levels;
+    const uint8_t* m_data { nullptr };
+    size_t m_size { 0 };
+    // without mmap (Windows) the file is read into memory
+    std::vector<uint8_t> m_fileData;
+};
+
+#endif // __TEXTURE_CONTAINER_H__
@@ -0,0 +1,101 @@
+#include "texture_loader.h"
+#include <filesystem>
+
+TextureLoaderUPtr TextureLoader::Create(WorkerPool* pool, size_t uploadBytesPerFrame,
+    const std::string& cookedDirectory) {
+    auto loader = TextureLoaderUPtr(new TextureLoader());
+    if (!loader->Init(pool, uploadBytesPerFrame, cookedDirectory))
+        return nullptr;
+    return std::move(loader);
+}
+
+bool TextureLoader::Init(WorkerPool* pool, size_t uploadBytesPerFrame,
+    const std::string& cookedDirectory) {
+    m_pool = pool;
+    m_cookedDirectory = cookedDirectory;
+    m_uploads = TextureUploadQueue::Create(uploadBytesPerFrame);
+    if (!m_uploads)
+        return false;
+    // 모든 placeholder가 같은 체크무늬 이미지를 사용
+    m_placeholder = Image::Create(64, 64);
+    if (!m_placeholder)
+        return false;
+    m_placeholder->SetCheckImage(8, 8);
+    return true;
+}
+
+std::string TextureLoader::GetCookedPath(const std::string& filepath) const {
+    auto stem = std::filesystem::path(filepath).stem().string();
+    return m_cookedDirectory + "/" + stem + ".tex";
+}
+
+std::future<ImageUPtr> TextureLoader::LoadImageAsync(const std::string& filepath) {
+    // WorkerPool 작업은 복사 가능해야 하므로 promise를 shared_ptr로 넘김
+    auto promise = std::make_shared<std::promise<ImageUPtr>>();
+    auto future = promise->get_future();
+    m_pool->Submit([promise, filepath]() {
+        promise->set_value(Image::Load(filepath));
+    });
+    return future;
+}
+
+TexturePtr TextureLoader::Load(const std::string& filepath) {
+    TexturePtr texture = Texture::CreateFromImage(m_placeholder.get());
+
+    auto promise = std::make_shared<std::promise<Loaded>>();
+    std::string cooked = GetCookedPath(filepath);
+    m_pool->Submit([promise, filepath, cooked]() {
+        Loaded loaded;
+        // 원본보다 오래된 cooked 파일은 무시 (다시 cook 하기 전까지는 디코딩)
+        std::error_code error;
+        auto cookedTime = std::filesystem::last_write_time(cooked, error);
+        if (!error) {
+            auto sourceTime = std::filesystem::last_write_time(filepath, error);
+            if (error || cookedTime >= sourceTime) {
+                // 페이지를 여기서 미리 읽어서 업로드 중에 디스크를 기다리지 않게
+                loaded.container = TextureContainer::Open(cooked, true);
+                if (!loaded.container)
+                    SPDLOG_WARN("invalid cooked texture {}, decoding {}", cooked, filepath);
+            }
+        }
+        if (!loaded.container)
+            loaded.image = Image::Load(filepath);
+        promise->set_value(std::move(loaded));
+    });
+
+    Pending pending;
+    pending.filepath = filepath;
+    pending.loaded = promise->get_future();
+    pending.texture = texture;
+    m_pending.push_back(std::move(pending));
+    return texture;
+}
+
+void TextureLoader::Update() {
+    for (size_t i = 0; i < m_pending.size(); ) {
+        auto& pending = m_pending[i];
+        if (pending.loaded.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            i++;
+            continue;
+        }
+        auto loaded = pending.loaded.get();
+        auto texture = pending.texture.lock();
+        // 업로드는 예산에 맞춰 여러 프레임에 나눠서
+        if (texture && loaded.container) {
+            auto& header = loaded.container->GetHeader();
+            SPDLOG_INFO("cooked texture: {} {}x{}, {} levels", pending.filepath,
+                header.width, header.height, header.levelCount);
+            m_uploads->Enqueue(texture, std::move(loaded.container));
+            m_cookedCount++;
+        }
+        else if (texture && loaded.image) {
+            SPDLOG_INFO("image: {} {}x{}, {} channels", pending.filepath,
+                loaded.image->GetWidth(), loaded.image->GetHeight(), loaded.image->GetChannelCount());
+            m_uploads->Enqueue(texture, std::move(loaded.image));
+        }
+        // 순서는 상관없으므로 마지막 원소와 바꿔서 제거
+        std::swap(pending, m_pending.back());
+        m_pending.pop_back();
+    }
+    m_uploads->Update();
+}
@@ -0,0 +1,65 @@
+#ifndef __TEXTURE_LOADER_H__
+#define __TEXTURE_LOADER_H__
+
+#include "common.h"
+#include "texture.h"
+#include "texture_upload.h"
+#include "texture_container.h"
+#include "worker_pool.h"
+#include <future>
+
+// loads textures on a WorkerPool so startup does not wait for the disk or
+// stb_image. Load hands back a texture showing a checkerboard right away;
+// Update (render thread, once per frame) hands finished loads to a
+// TextureUploadQueue, which swaps the real pixels in over the next frames.
+// a cooked container (<cookedDirectory>/<name>.tex, see tools/texture_cooker)
+// that is newer than the image is memory-mapped instead of decoding
+// the build passes the directory the cook_textures target writes to
+#ifndef COOKED_TEXTURE_DIR
+#define COOKED_TEXTURE_DIR "./cooked"
+#endif
+
+CLASS_PTR(TextureLoader)
+class TextureLoader {
+public:
+    static TextureLoaderUPtr Create(WorkerPool* pool = &WorkerPool::Shared(),
+        size_t uploadBytesPerFrame = 4 * 1024 * 1024,
+        const std::string& cookedDirectory = COOKED_TEXTURE_DIR);
+
+    // decode only. the future holds nullptr if the file could not be read
+    std::future<ImageUPtr> LoadImageAsync(const std::string& filepath);
+    // placeholder texture whose contents are replaced once loaded. a failed
+    // load keeps the checkerboard
+    TexturePtr Load(const std::string& filepath);
+
+    void Update();
+    // still loading / loaded but not yet handed to the upload queue
+    size_t GetPendingCount() const { return m_pending.size(); }
+    const TextureUploadQueue* GetUploadQueue() const { return m_uploads.get(); }
+    uint32_t GetCookedCount() const { return m_cookedCount; }
+
+private:
+    TextureLoader() {}
+    bool Init(WorkerPool* pool, size_t uploadBytesPerFrame, const std::string& cookedDirectory);
+    std::string GetCookedPath(const std::string& filepath) const;
+
+    // exactly one of them is set on success
+    struct Loaded {
+        std::unique_ptr<TextureContainer> container;
+        ImageUPtr image;
+    };
+    struct Pending {
+        std::string filepath;
+        std::future<Loaded> loaded;
+        // the texture may be dropped before its pixels arrive
+        TextureWPtr texture;
+    };
+    WorkerPool* m_pool { nullptr };
+    std::string m_cookedDirectory;
+    ImageUPtr m_placeholder;
+    TextureUploadQueueUPtr m_uploads;
+    std::vector<Pending> m_pending;
+    uint32_t m_cookedCount { 0 };
+};
+
+#endif // __TEXTURE_LOADER_H__
@@ -0,0 +1,170 @@
+#include "texture_upload.h"
+#include <algorithm>
+#include <cstring>
+
+TextureUploadQueueUPtr TextureUploadQueue::Create(size_t bytesPerFrame) {
+    auto queue = TextureUploadQueueUPtr(new TextureUploadQueue());
+    if (!queue->Init(bytesPerFrame))
+        return nullptr;
+    return std::move(queue);
+}
+
+TextureUploadQueue::~TextureUploadQueue() {
+    for (auto& finishing : m_finishing)
+        glDeleteSync(finishing.fence);
+}
+
+bool TextureUploadQueue::Init(size_t bytesPerFrame) {
+    m_stream = StreamBuffer::Create(GL_PIXEL_UNPACK_BUFFER, bytesPerFrame);
+    // unpack buffer이 bind된 채로 있으면 다른 glTexImage2D의 포인터가 offset으로 해석됨
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    return m_stream != nullptr;
+}
+
+void TextureUploadQueue::Enqueue(const TexturePtr& target, ImageUPtr image) {
+    Job job;
+    job.target = target;
+    job.levels.push_back({ image->GetData(), image->GetWidth(), image->GetHeight(),
+        (size_t)image->GetWidth() * image->GetChannelCount() });
+    job.channelCount = image->GetChannelCount();
+    job.internalFormat = Texture::GetImageInternalFormat(job.channelCount);
+    job.generateMipmap = true;
+    job.source = std::shared_ptr<Image>(std::move(image));
+    m_jobs.push_back(std::move(job));
+}
+
+void TextureUploadQueue::Enqueue(const TexturePtr& target, std::unique_ptr<TextureContainer> container) {
+    auto& header = container->GetHeader();
+    Job job;
+    job.target = target;
+    for (int i = 0; i < (int)header.levelCount; i++) {
+        auto& level = container->GetLevel(i);
+        job.levels.push_back({ container->GetLevelData(i), (int)level.width, (int)level.height,
+            (size_t)level.rowPitch });
+    }
+    job.channelCount = header.channelCount;
+    job.rowAlignment = header.rowAlignment;
+    job.internalFormat = header.internalFormat;
+    // mip이 하나뿐인 container만 GPU에서 생성
+    job.generateMipmap = header.levelCount == 1;
+    job.source = std::shared_ptr<TextureContainer>(std::move(container));
+    m_jobs.push_back(std::move(job));
+}
+
+size_t TextureUploadQueue::GetPendingBytes() const {
+    size_t bytes = 0;
+    for (auto& job : m_jobs) {
+        for (int i = job.level; i < (int)job.levels.size(); i++) {
+            auto& level = job.levels[i];
+            int rows = i == job.level ? level.height - job.nextRow : level.height;
+            bytes += level.rowPitch * rows;
+        }
+    }
+    return bytes;
+}
+
+void TextureUploadQueue::Update() {
+    Finish();
+    if (m_jobs.empty())
+        return;
+
+    // 1. 이번 프레임 예산만큼 행 단위로 잘라서 PBO에 복사
+    struct Band {
+        Job* job;
+        int level;
+        int y;
+        int rowCount;
+        size_t offset;
+    };
+    std::vector<Band> bands;
+    const size_t alignment = 16;
+    size_t budget = m_stream->GetFrameSize();
+    bool full = false;
+    m_stream->BeginFrame();
+    for (auto& job : m_jobs) {
+        if (full)
+            break;
+        if (job.target.expired())
+            continue;
+        if (!job.staging) {
+            // BeginFrame의 map이 PBO를 bind하므로 (nullptr가 offset 0이 됨) 먼저 해제
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            job.staging = Texture::Create(job.levels[0].width, job.levels[0].height,
+                job.generateMipmap ? 1 : (int)job.levels.size(), job.internalFormat);
+        }
+        while (job.level < (int)job.levels.size()) {
+            auto& level = job.levels[job.level];
+            if (level.rowPitch > m_stream->GetFrameSize()) {
+                // 한 줄도 예산에 안 들어가는 레벨은 예외적으로 바로 업로드
+                SPDLOG_WARN("texture row of {} bytes exceeds the upload budget", level.rowPitch);
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                job.staging->SetRows(job.level, job.nextRow, level.height - job.nextRow,
+                    level.width, job.channelCount, job.rowAlignment,
+                    level.data + level.rowPitch * job.nextRow);
+                job.level++;
+                job.nextRow = 0;
+                continue;
+            }
+
+            // 남은 예산에 들어가는 행만 (정렬 여유분 제외)
+            int rowCount = std::min(level.height - job.nextRow,
+                budget > alignment ? (int)((budget - alignment) / level.rowPitch) : 0);
+            size_t offset = 0;
+            auto dest = rowCount > 0 ?
+                (uint8_t*)m_stream->Allocate(level.rowPitch * rowCount, alignment, &offset) : nullptr;
+            if (!dest) {
+                full = true;
+                break;
+            }
+            memcpy(dest, level.data + level.rowPitch * job.nextRow, level.rowPitch * rowCount);
+            budget -= level.rowPitch * rowCount + alignment;
+            bands.push_back({ &job, job.level, job.nextRow, rowCount, offset });
+            job.nextRow += rowCount;
+            if (job.nextRow == level.height) {
+                job.level++;
+                job.nextRow = 0;
+            }
+        }
+    }
+    m_stream->FinishWrites();
+
+    // 2. PBO에서 staging 텍스처로 복사 (GPU에서 비동기로 진행)
+    m_stream->GetBuffer()->Bind();
+    for (auto& band : bands) {
+        Job& job = *band.job;
+        job.staging->SetRows(band.level, band.y, band.rowCount, job.levels[band.level].width,
+            job.channelCount, job.rowAlignment, (const void*)band.offset);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    m_stream->EndFrame();
+
+    // 3. 모든 레벨을 보낸 텍스처는 (필요하면 mipmap 생성 후) fence로 완료 대기
+    while (!m_jobs.empty()) {
+        Job& job = m_jobs.front();
+        if (!job.target.expired() && job.level < (int)job.levels.size())
+            break;
+        if (!job.target.expired()) {
+            if (job.generateMipmap)
+                job.staging->GenerateMipmap();
+            Finishing finishing;
+            finishing.target = job.target;
+            finishing.staging = std::move(job.staging);
+            finishing.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            m_finishing.push_back(std::move(finishing));
+        }
+        m_jobs.pop_front();
+    }
+}
+
+void TextureUploadQueue::Finish() {
+    // 완료된 것만 교체, 기다리지 않음
+    while (!m_finishing.empty()) {
+        auto& finishing = m_finishing.front();
+        if (glClientWaitSync(finishing.fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            break;
+        glDeleteSync(finishing.fence);
+        if (auto target = finishing.target.lock())
+            target->Swap(*finishing.staging);
+        m_finishing.pop_front();
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef __TEXTURE_UPLOAD_H__
+#define __TEXTURE_UPLOAD_H__
+
+#include "common.h"
+#include "texture.h"
+#include "stream_buffer.h"
+#include "texture_container.h"
+#include <deque>
+
+// spreads texture uploads over frames. pixels are copied into a ring of
+// pixel unpack buffers (StreamBuffer, fenced per frame) at most
+// bytesPerFrame at a time, in bands of whole rows, into a staging texture.
+// after the last band (and mipmap generation for plain images) a fence is
+// inserted, and once it has signaled the staging texture is swapped into
+// the target
+CLASS_PTR(TextureUploadQueue)
+class TextureUploadQueue {
+public:
+    static TextureUploadQueueUPtr Create(size_t bytesPerFrame = 4 * 1024 * 1024);
+    ~TextureUploadQueue();
+
+    // target keeps its current contents (e.g. a placeholder) until done.
+    // an image uploads level 0 and gets its mipmaps generated on the GPU
+    void Enqueue(const TexturePtr& target, ImageUPtr image);
+    // a cooked container uploads every level straight from its mapping
+    void Enqueue(const TexturePtr& target, std::unique_ptr<TextureContainer> container);
+    // once per frame on the render thread
+    void Update();
+
+    size_t GetPendingCount() const { return m_jobs.size() + m_finishing.size(); }
+    size_t GetPendingBytes() const;
+    size_t GetBytesPerFrame() const { return m_stream->GetFrameSize(); }
+    uint32_t GetStallCount() const { return m_stream->GetStallCount(); }
+
+private:
+    TextureUploadQueue() {}
+    bool Init(size_t bytesPerFrame);
+    void Finish();
+
+    // source rows of one mip level, rowPitch bytes apart
+    struct Level {
+        const uint8_t* data;
+        int width;
+        int height;
+        size_t rowPitch;
+    };
+    struct Job {
+        TextureWPtr target;
+        std::shared_ptr<void> source;  // keeps the image / mapping alive
+        std::vector<Level> levels;
+        int channelCount { 4 };
+        int rowAlignment { 1 };
+        uint32_t internalFormat { GL_RGBA8 };
+        bool generateMipmap { false };
+        TextureUPtr staging;
+        int level { 0 };
+        int nextRow { 0 };
+    };
+    struct Finishing {
+        TextureWPtr target;
+        TextureUPtr staging;
+        GLsync fence { nullptr };
+    };
+    StreamBufferUPtr m_stream;
+    std::deque<Job> m_jobs;
+    std::deque<Finishing> m_finishing;
+};
+
+#endif // __TEXTURE_UPLOAD_H__
@@ -0,0 +1,105 @@
+#include "uniform_buffer.h"
+#include <cstring>
+#include <map>
+
+// base alignment and size of one element (std140 / std430 rules 1-5)
+static void GetMemberInfo(BlockMemberType type, size_t* alignment, size_t* size) {
+    switch (type) {
+        case BlockMemberType::Float:
+        case BlockMemberType::Int:
+        case BlockMemberType::UInt: *alignment = 4; *size = 4; break;
+        case BlockMemberType::Vec2: *alignment = 8; *size = 8; break;
+        case BlockMemberType::Vec3: *alignment = 16; *size = 12; break;
+        case BlockMemberType::Vec4:
+        case BlockMemberType::IVec4: *alignment = 16; *size = 16; break;
+        // 행렬은 열 벡터의 배열, vec3 열도 16바이트 간격
+        case BlockMemberType::Mat3: *alignment = 16; *size = 48; break;
+        case BlockMemberType::Mat4: *alignment = 16; *size = 64; break;
+    }
+}
+
+static size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+size_t BlockLayoutBuilder::Add(BlockMemberType type, int arrayCount) {
+    size_t alignment = 0, size = 0;
+    GetMemberInfo(type, &alignment, &size);
+    if (arrayCount > 0) {
+        // std140은 배열 원소를 vec4 단위로 정렬, std430은 원소 정렬 그대로
+        if (m_layout == BlockLayout::Std140)
+            alignment = AlignUp(alignment, 16);
+        size = AlignUp(size, alignment) * arrayCount;
+    }
+    size_t offset = AlignUp(m_offset, alignment);
+    m_offset = offset + size;
+    m_maxAlignment = std::max(m_maxAlignment, alignment);
+    return offset;
+}
+
+size_t BlockLayoutBuilder::GetSize() const {
+    size_t alignment = m_layout == BlockLayout::Std140 ?
+        AlignUp(m_maxAlignment, 16) : m_maxAlignment;
+    return AlignUp(m_offset, alignment);
+}
+
+static std::map<std::string, uint32_t>& GetBindingTable() {
+    static std::map<std::string, uint32_t> table;
+    return table;
+}
+
+uint32_t UniformBlockBindings::Register(const std::string& blockName) {
+    auto& table = GetBindingTable();
+    auto found = table.find(blockName);
+    if (found != table.end())
+        return found->second;
+    uint32_t point = (uint32_t)table.size();
+    table[blockName] = point;
+    return point;
+}
+
+int UniformBlockBindings::Find(const std::string& blockName) {
+    auto& table = GetBindingTable();
+    auto found = table.find(blockName);
+    return found == table.end() ? -1 : (int)found->second;
+}
+
+UniformBufferUPtr UniformBuffer::Create(const std::string& blockName, size_t size) {
+    auto buffer = UniformBufferUPtr(new UniformBuffer());
+    if (!buffer->Init(blockName, size))
+        return nullptr;
+    return std::move(buffer);
+}
+
+bool UniformBuffer::Init(const std::string& blockName, size_t size) {
+    m_data.resize(size, 0);
+    m_buffer = Buffer::CreateWithData(GL_UNIFORM_BUFFER, GL_DYNAMIC_DRAW, m_data.data(), size);
+    if (!m_buffer)
+        return false;
+    m_bindingPoint = UniformBlockBindings::Register(blockName);
+    glBindBufferBase(GL_UNIFORM_BUFFER, m_bindingPoint, m_buffer->Get());
+    return true;
+}
+
+void UniformBuffer::Write(size_t offset, const void* data, size_t size) {
+    if (offset + size > m_data.size())
+        return;
+    if (memcmp(m_data.data() + offset, data, size) == 0)
+        return;
+    memcpy(m_data.data() + offset, data, size);
+    if (m_dirtyBegin == m_dirtyEnd) {
+        m_dirtyBegin = offset;
+        m_dirtyEnd = offset + size;
+    }
+    else {
+        m_dirtyBegin = std::min(m_dirtyBegin, offset);
+        m_dirtyEnd = std::max(m_dirtyEnd, offset + size);
+    }
+}
+
+void UniformBuffer::Upload() {
+    if (m_dirtyBegin == m_dirtyEnd)
+        return;
+    m_buffer->UpdateData(m_data.data() + m_dirtyBegin, m_dirtyEnd - m_dirtyBegin, m_dirtyBegin);
+    m_dirtyBegin = m_dirtyEnd = 0;
+}
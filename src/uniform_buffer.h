@@ -0,0 +1,73 @@
+#ifndef __UNIFORM_BUFFER_H__
+#define __UNIFORM_BUFFER_H__
+
+#include "common.h"
+#include "buffer.h"
+#include <vector>
+
+enum class BlockLayout {
+    Std140,  // uniform blocks
+    Std430,  // shader storage blocks (arrays of scalars / vec2 are packed)
+};
+
+enum class BlockMemberType {
+    Float, Int, UInt,
+    Vec2, Vec3, Vec4,
+    IVec4,
+    Mat3, Mat4,
+};
+
+// computes member offsets of an interface block in declaration order so
+// a C++ side staging buffer can match the GLSL declaration exactly
+class BlockLayoutBuilder {
+public:
+    explicit BlockLayoutBuilder(BlockLayout layout = BlockLayout::Std140) : m_layout(layout) {}
+
+    // returns the byte offset of the member. arrayCount > 0 declares an array
+    size_t Add(BlockMemberType type, int arrayCount = 0);
+    // block size including the trailing padding of the block's alignment
+    size_t GetSize() const;
+
+private:
+    BlockLayout m_layout;
+    size_t m_offset { 0 };
+    size_t m_maxAlignment { 4 };
+};
+
+// uniform block name -> binding point, shared by every Program. blocks
+// registered before a program links are bound to their point at link time
+class UniformBlockBindings {
+public:
+    // returns the existing point if the name is already registered
+    static uint32_t Register(const std::string& blockName);
+    // -1 if not registered
+    static int Find(const std::string& blockName);
+};
+
+// CPU staging copy of a uniform block, written with Set and uploaded in
+// one glBufferSubData covering the changed range
+CLASS_PTR(UniformBuffer)
+class UniformBuffer {
+public:
+    // registers blockName and binds the buffer to its binding point
+    static UniformBufferUPtr Create(const std::string& blockName, size_t size);
+
+    uint32_t GetBindingPoint() const { return m_bindingPoint; }
+
+    template <typename T>
+    void Set(size_t offset, const T& value) { Write(offset, &value, sizeof(T)); }
+    void Write(size_t offset, const void* data, size_t size);
+    void Upload();
+
+private:
+    UniformBuffer() {}
+    bool Init(const std::string& blockName, size_t size);
+
+    BufferUPtr m_buffer;
+    uint32_t m_bindingPoint { 0 };
+    std::vector<uint8_t> m_data;
+    size_t m_dirtyBegin { 0 };
+    size_t m_dirtyEnd { 0 };
+};
+
+#endif // __UNIFORM_BUFFER_H__
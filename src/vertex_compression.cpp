@@ -0,0 +1,115 @@
+#include "vertex_compression.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (((bits >> 23) & 0xFF) == 0xFF)                      // inf / nan
+        return (uint16_t)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    if (exponent >= 31)                                      // overflow
+        return (uint16_t)(sign | 0x7C00);
+    if (exponent <= 0) {                                     // subnormal / zero
+        if (exponent < -10)
+            return (uint16_t)sign;
+        mantissa |= 0x800000;
+        uint32_t shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1)))
+            half++;
+        return (uint16_t)(sign | half);
+    }
+    // round to nearest even, carry may bump the exponent
+    uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+        half++;
+    return (uint16_t)half;
+}
+
+float HalfToFloat(uint16_t value) {
+    uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1F;
+    uint32_t mantissa = value & 0x3FF;
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        }
+        else {
+            // normalize the subnormal
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+        }
+    }
+    else if (exponent == 31) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    }
+    else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+int16_t FloatToSnorm16(float value) {
+    value = std::min(1.0f, std::max(-1.0f, value));
+    return (int16_t)std::lround(value * 32767.0f);
+}
+
+uint32_t PackSnorm2101010(float x, float y, float z) {
+    auto pack10 = [](float v) {
+        v = std::min(1.0f, std::max(-1.0f, v));
+        return (uint32_t)((int32_t)std::lround(v * 511.0f) & 0x3FF);
+    };
+    return pack10(x) | (pack10(y) << 10) | (pack10(z) << 20);
+}
+
+PositionQuantization ComputePositionQuantization(const MeshData& mesh) {
+    PositionQuantization quantization;
+    for (int k = 0; k < 3; k++) {
+        quantization.center[k] = (mesh.boundsMin[k] + mesh.boundsMax[k]) * 0.5f;
+        float halfExtent = (mesh.boundsMax[k] - mesh.boundsMin[k]) * 0.5f;
+        // flat axis: anything non-zero works, the snorm value is 0
+        quantization.halfExtent[k] = halfExtent > 0.0f ? halfExtent : 1.0f;
+    }
+    return quantization;
+}
+
+void CompressVertices(const MeshData& mesh, const PositionQuantization& quantization,
+    CompactVertex* out) {
+    float scale[3];
+    for (int k = 0; k < 3; k++)
+        scale[k] = 1.0f / quantization.halfExtent[k];
+
+    size_t vertexCount = mesh.GetVertexCount();
+    for (size_t i = 0; i < vertexCount; i++) {
+        const float* p = &mesh.positions[i * 3];
+        const float* n = &mesh.normals[i * 3];
+        const float* uv = &mesh.texCoords[i * 2];
+        auto& v = out[i];
+        for (int k = 0; k < 3; k++)
+            v.position[k] = FloatToSnorm16((p[k] - quantization.center[k]) * scale[k]);
+        v.position[3] = 0;
+        v.normal = PackSnorm2101010(n[0], n[1], n[2]);
+        v.texCoord[0] = FloatToHalf(uv[0]);
+        v.texCoord[1] = FloatToHalf(uv[1]);
+    }
+}
+
+void CompressIndices(const uint32_t* indices, size_t indexCount, uint16_t* out) {
+    for (size_t i = 0; i < indexCount; i++)
+        out[i] = indices[i] == kPrimitiveRestartIndex ? 0xFFFF : (uint16_t)indices[i];
+}
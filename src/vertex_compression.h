@@ -0,0 +1,39 @@
+#ifndef __VERTEX_COMPRESSION_H__
+#define __VERTEX_COMPRESSION_H__
+
+#include "mesh_data.h"
+
+// 16 byte vertex, half of the 32 byte float layout:
+//   position: snorm16 x3 (+ pad) relative to the mesh bounds
+//   normal:   snorm 2_10_10_10_REV
+//   texcoord: half float x2
+struct CompactVertex {
+    int16_t position[4];
+    uint32_t normal;
+    uint16_t texCoord[2];
+};
+static_assert(sizeof(CompactVertex) == 16, "CompactVertex must stay 16 bytes");
+
+// maps the quantized [-1, 1] cube back onto the mesh bounds:
+// position = center + snorm * halfExtent
+struct PositionQuantization {
+    float center[3] { 0.0f, 0.0f, 0.0f };
+    float halfExtent[3] { 1.0f, 1.0f, 1.0f };
+};
+
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t value);
+int16_t FloatToSnorm16(float value);
+uint32_t PackSnorm2101010(float x, float y, float z);
+
+// needs mesh bounds (MeshData::ComputeBounds)
+PositionQuantization ComputePositionQuantization(const MeshData& mesh);
+void CompressVertices(const MeshData& mesh, const PositionQuantization& quantization,
+    CompactVertex* out);
+
+// 0xFFFF stays free as the primitive restart index
+inline bool CanUse16BitIndices(size_t vertexCount) { return vertexCount < 0xFFFF; }
+// kPrimitiveRestartIndex becomes 0xFFFF
+void CompressIndices(const uint32_t* indices, size_t indexCount, uint16_t* out);
+
+#endif // __VERTEX_COMPRESSION_H__
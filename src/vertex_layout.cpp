@@ -25,6 +25,10 @@ void VertexLayout::SetAttrib(
         type, normalized, stride, (const void*)offset);
 }
 
+void VertexLayout::SetAttribDivisor(uint32_t attribIndex, uint32_t divisor) const {
+    glVertexAttribDivisor(attribIndex, divisor);
+}
+
 void VertexLayout::Init() {
     glGenVertexArrays(1, &m_vertexArrayObject);
     Bind();
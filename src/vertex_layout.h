@@ -16,6 +16,8 @@ public:
         uint32_t type, bool normalized,
         size_t stride, uint64_t offset) const;
     void DisableAttrib(int attribIndex) const;
+    // 0: per vertex, n: advance once every n instances
+    void SetAttribDivisor(uint32_t attribIndex, uint32_t divisor) const;
 
 private:
     VertexLayout() {}
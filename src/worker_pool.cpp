@@ -0,0 +1,87 @@
+#include "worker_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+WorkerPool& WorkerPool::Shared() {
+    static WorkerPool pool(std::max(1, (int)std::thread::hardware_concurrency() - 1));
+    return pool;
+}
+
+WorkerPool::WorkerPool(int threadCount) {
+    for (int i = 0; i < threadCount; i++)
+        m_threads.emplace_back([this] { WorkerLoop(); });
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_condition.notify_all();
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+void WorkerPool::Submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void WorkerPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+            if (m_stop && m_tasks.empty())
+                return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void WorkerPool::ParallelFor(int count, int grain, const std::function<void(int, int)>& fn) {
+    if (count <= 0)
+        return;
+    grain = std::max(1, grain);
+    int chunkCount = (count + grain - 1) / grain;
+    if (chunkCount == 1 || m_threads.empty()) {
+        fn(0, count);
+        return;
+    }
+
+    // helpers may start after the caller already finished every chunk,
+    // so the shared state outlives this call
+    struct Job {
+        std::atomic<int> next { 0 };
+        std::atomic<int> done { 0 };
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto job = std::make_shared<Job>();
+    auto run = [job, &fn, count, grain, chunkCount]() {
+        int chunk;
+        while ((chunk = job->next.fetch_add(1)) < chunkCount) {
+            int begin = chunk * grain;
+            fn(begin, std::min(count, begin + grain));
+            if (job->done.fetch_add(1) + 1 == chunkCount) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->finished.notify_all();
+            }
+        }
+    };
+
+    int helperCount = std::min(GetThreadCount(), chunkCount - 1);
+    for (int i = 0; i < helperCount; i++)
+        Submit(run);
+    run();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&job, chunkCount] { return job->done.load() == chunkCount; });
+}
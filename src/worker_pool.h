@@ -0,0 +1,40 @@
+#ifndef __WORKER_POOL_H__
+#define __WORKER_POOL_H__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fixed-size thread pool. ParallelFor splits a range into chunks that
+// write disjoint output slices, so results do not depend on scheduling.
+class WorkerPool {
+public:
+    // process-wide pool with (hardware threads - 1) workers
+    static WorkerPool& Shared();
+
+    explicit WorkerPool(int threadCount);
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    int GetThreadCount() const { return (int)m_threads.size(); }
+    void Submit(std::function<void()> task);
+
+    // calls fn(begin, end) over [0, count) in chunks of at least grain
+    // items. the calling thread takes part and returns once all chunks ran.
+    void ParallelFor(int count, int grain, const std::function<void(int, int)>& fn);
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_threads;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stop { false };
+};
+
+#endif // __WORKER_POOL_H__
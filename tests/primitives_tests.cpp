@@ -0,0 +1,484 @@
+// Headless regression tests for the GL-free primitives library.
+// usage: primitives_tests (prints each failed check, exits with 1 if any failed)
+#include "primitives.h"
+#include "ring.h"
+#include "mesh_optimizer.h"
+#include "vertex_compression.h"
+#include "buddy_allocator.h"
+#include "image_kernels.h"
+#include "texture_container.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+static int g_failures = 0;
+
+#define CHECK(condition) do { \
+    if (!(condition)) { \
+        g_failures++; \
+        printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+    } \
+} while (0)
+
+// primitives
+
+static void CheckMesh(const char* name, const MeshData& mesh) {
+    size_t vertexCount = mesh.GetVertexCount();
+    CHECK(vertexCount > 0);
+    CHECK(mesh.positions.size() == vertexCount * 3);
+    CHECK(mesh.normals.size() == vertexCount * 3);
+    CHECK(mesh.texCoords.size() == vertexCount * 2);
+
+    size_t badIndices = 0, badNormals = 0, badTexCoords = 0;
+    for (auto index : mesh.indices) {
+        bool restart = index == kPrimitiveRestartIndex;
+        if (restart ? mesh.topology != PrimitiveTopology::TriangleStrip : index >= vertexCount)
+            badIndices++;
+    }
+    for (size_t i = 0; i < vertexCount; i++) {
+        const float* n = &mesh.normals[i * 3];
+        if (std::fabs(std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) - 1.0f) > 1e-4f)
+            badNormals++;
+        for (int k = 0; k < 2; k++) {
+            float uv = mesh.texCoords[i * 2 + k];
+            if (uv < 0.0f || uv > 1.0f)
+                badTexCoords++;
+        }
+    }
+    if (badIndices || badNormals || badTexCoords)
+        printf("%s: %zu bad indices, %zu bad normals, %zu bad texcoords\n",
+            name, badIndices, badNormals, badTexCoords);
+    CHECK(badIndices == 0);
+    CHECK(badNormals == 0);
+    CHECK(badTexCoords == 0);
+
+    if (mesh.topology == PrimitiveTopology::Triangles) {
+        CHECK(mesh.indices.size() % 3 == 0);
+        CHECK(mesh.GetTriangleCount() == mesh.indices.size() / 3);
+    }
+    else {
+        // 앞뒤나 연속된 restart는 빈 strip
+        CHECK(!mesh.indices.empty() && mesh.indices.front() != kPrimitiveRestartIndex);
+        CHECK(mesh.indices.back() != kPrimitiveRestartIndex);
+        for (size_t i = 1; i < mesh.indices.size(); i++)
+            CHECK(!(mesh.indices[i] == kPrimitiveRestartIndex && mesh.indices[i - 1] == kPrimitiveRestartIndex));
+    }
+}
+
+static void TestGenerators() {
+    for (auto topology : { PrimitiveTopology::Triangles, PrimitiveTopology::TriangleStrip }) {
+        TessellationOptions options;
+        options.topology = topology;
+        CheckMesh("box", GenerateBox());
+        CheckMesh("cylinder", GenerateCylinder(0.5f, 0.3f, 32, 1.0f, options));
+        CheckMesh("cone", GenerateCylinder(0.5f, 0.0f, 3, 1.0f, options));
+        CheckMesh("sphere", GenerateSphere(0.5f, 32, 16, options));
+        CheckMesh("sphere 3x2", GenerateSphere(0.5f, 3, 2, options));
+        CheckMesh("torus", GenerateTorus(0.3f, 0.15f, 32, 16, options));
+        CheckMesh("torus 3x3", GenerateTorus(0.3f, 0.15f, 3, 3, options));
+    }
+
+    // 병렬 생성은 직렬과 같은 결과
+    TessellationOptions serial;
+    serial.parallel = false;
+    TessellationOptions parallel;
+    parallel.parallelThreshold = 0;
+    auto a = GenerateSphere(0.5f, 300, 200, serial);
+    auto b = GenerateSphere(0.5f, 300, 200, parallel);
+    CHECK(a.positions == b.positions && a.normals == b.normals && a.indices == b.indices);
+    a = GenerateTorus(0.3f, 0.15f, 300, 200, serial);
+    b = GenerateTorus(0.3f, 0.15f, 300, 200, parallel);
+    CHECK(a.positions == b.positions && a.texCoords == b.texCoords && a.indices == b.indices);
+    a = GenerateCylinder(0.5f, 0.3f, 100000, 1.0f, serial);
+    b = GenerateCylinder(0.5f, 0.3f, 100000, 1.0f, parallel);
+    CHECK(a.positions == b.positions && a.indices == b.indices);
+
+    // 위치만 갱신하는 경로는 index 없이 같은 정점
+    TessellationOptions verticesOnly;
+    verticesOnly.generateIndices = false;
+    auto full = GenerateSphere(0.5f, 32, 16);
+    auto partial = GenerateSphere(0.5f, 32, 16, verticesOnly);
+    CHECK(partial.indices.empty());
+    CHECK(partial.positions == full.positions);
+}
+
+// ring
+
+static void TestSinCos() {
+    // SIMD 본체와 scalar 꼬리가 모두 지나가도록 여러 개수로
+    for (int count : { 0, 1, 3, 4, 7, 8, 9, 31, 1000 }) {
+        std::vector<float> s(count), c(count);
+        double start = 0.25, step = 2.0 * 3.14159265358979323846 / 97.0;
+        ComputeSinCos(start, step, count, s.data(), c.data());
+        float maxError = 0.0f;
+        for (int i = 0; i < count; i++) {
+            double angle = start + step * i;
+            maxError = std::max(maxError, (float)std::fabs(s[i] - std::sin(angle)));
+            maxError = std::max(maxError, (float)std::fabs(c[i] - std::cos(angle)));
+        }
+        CHECK(maxError < 1e-5f);
+    }
+
+    auto table = MakeCircleTable(37);
+    CHECK(table.GetCount() == 38);
+    CHECK(table.sin.back() == table.sin.front() && table.cos.back() == table.cos.front());
+
+    std::vector<float> ring(table.GetCount() * 3);
+    EmitRing(table, 0, table.GetCount(), 2.0f, 0.5f, RingAxis::Y, ring.data());
+    for (int i = 0; i < table.GetCount(); i++) {
+        CHECK(ring[i * 3 + 0] == table.cos[i] * 2.0f);
+        CHECK(ring[i * 3 + 1] == 0.5f);
+        CHECK(ring[i * 3 + 2] == table.sin[i] * 2.0f);
+    }
+}
+
+// mesh optimizer
+
+static std::vector<std::array<uint32_t, 3>> GetSortedTriangles(const std::vector<uint32_t>& indices) {
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+        // 감는 방향은 유지한 채 가장 작은 index가 앞에 오도록 회전
+        std::array<uint32_t, 3> t { indices[i], indices[i + 1], indices[i + 2] };
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+        triangles.push_back(t);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+
+static void TestMeshOptimizer() {
+    // 삼각형 하나: 정점 3개 모두 miss
+    const uint32_t one[] = { 0, 1, 2 };
+    auto stats = AnalyzeVertexCache(one, 3, 3);
+    CHECK(stats.acmr == 3.0f);
+    CHECK(stats.atvr == 1.0f);
+
+    for (auto mesh : { GenerateSphere(0.5f, 100, 100), GenerateTorus(0.3f, 0.15f, 300, 100) }) {
+        auto before = GetSortedTriangles(mesh.indices);
+        auto report = OptimizeMesh(mesh);
+        CHECK(GetSortedTriangles(mesh.indices) == before);
+        CHECK(report.after.acmr <= report.before.acmr);
+        CHECK(report.after.acmr < 1.0f);
+        CHECK(report.after.atvr >= 1.0f);
+    }
+
+    // strip은 분석만 하고 그대로 둠
+    TessellationOptions strips;
+    strips.topology = PrimitiveTopology::TriangleStrip;
+    auto strip = GenerateSphere(0.5f, 32, 16, strips);
+    auto indices = strip.indices;
+    OptimizeMesh(strip);
+    CHECK(strip.indices == indices);
+}
+
+// vertex compression
+
+static void TestVertexCompression() {
+    // 모든 유한한 half는 float를 거쳐도 같은 비트
+    int halfMismatches = 0;
+    for (uint32_t bits = 0; bits < 0x10000; bits++) {
+        if ((bits & 0x7C00) == 0x7C00 && (bits & 0x3FF))
+            continue;  // nan
+        if (FloatToHalf(HalfToFloat((uint16_t)bits)) != bits)
+            halfMismatches++;
+    }
+    CHECK(halfMismatches == 0);
+    CHECK(HalfToFloat(FloatToHalf(1.0f)) == 1.0f);
+    CHECK(HalfToFloat(FloatToHalf(-2.5f)) == -2.5f);
+    CHECK(HalfToFloat(FloatToHalf(65504.0f)) == 65504.0f);
+    CHECK(std::isinf(HalfToFloat(FloatToHalf(1e6f))));
+    CHECK(HalfToFloat(FloatToHalf(std::ldexp(1.0f, -24))) == std::ldexp(1.0f, -24));
+    float maxError = 0.0f;
+    for (int i = 0; i <= 1000; i++) {
+        float uv = i / 1000.0f;
+        maxError = std::max(maxError, std::fabs(HalfToFloat(FloatToHalf(uv)) - uv));
+    }
+    CHECK(maxError <= 1.0f / 4096.0f);
+
+    for (int i = -1000; i <= 1000; i++) {
+        float value = i / 1000.0f;
+        CHECK(std::fabs(FloatToSnorm16(value) / 32767.0f - value) <= 0.5f / 32767.0f + 1e-7f);
+    }
+    CHECK(FloatToSnorm16(2.0f) == 32767 && FloatToSnorm16(-2.0f) == -32767);
+
+    auto unpack10 = [](uint32_t packed, int field) {
+        int32_t value = (int32_t)((packed >> (field * 10)) & 0x3FF);
+        if (value & 0x200)
+            value -= 0x400;
+        return std::max(value / 511.0f, -1.0f);
+    };
+    for (int i = 0; i < 1000; i++) {
+        float x = std::cos(i * 0.1f) * std::sin(i * 0.37f);
+        float y = std::sin(i * 0.1f) * std::sin(i * 0.37f);
+        float z = std::cos(i * 0.37f);
+        uint32_t packed = PackSnorm2101010(x, y, z);
+        CHECK(std::fabs(unpack10(packed, 0) - x) <= 0.5f / 511.0f + 1e-6f);
+        CHECK(std::fabs(unpack10(packed, 1) - y) <= 0.5f / 511.0f + 1e-6f);
+        CHECK(std::fabs(unpack10(packed, 2) - z) <= 0.5f / 511.0f + 1e-6f);
+        CHECK((packed >> 30) == 0);
+    }
+
+    // 압축한 위치를 bounds로 되돌리면 원래 위치 근처
+    auto mesh = GenerateTorus(0.3f, 0.15f, 64, 32);
+    mesh.ComputeBounds();
+    auto quantization = ComputePositionQuantization(mesh);
+    std::vector<CompactVertex> vertices(mesh.GetVertexCount());
+    CompressVertices(mesh, quantization, vertices.data());
+    float positionError = 0.0f;
+    for (size_t i = 0; i < vertices.size(); i++) {
+        for (int k = 0; k < 3; k++) {
+            float decoded = quantization.center[k] +
+                vertices[i].position[k] / 32767.0f * quantization.halfExtent[k];
+            positionError = std::max(positionError, std::fabs(decoded - mesh.positions[i * 3 + k]));
+        }
+        CHECK(HalfToFloat(vertices[i].texCoord[0]) == HalfToFloat(FloatToHalf(mesh.texCoords[i * 2])));
+    }
+    CHECK(positionError <= 0.45f / 32767.0f * 2.0f);
+
+    const uint32_t indices[] = { 0, 1, 0xFFFE, kPrimitiveRestartIndex, 7 };
+    uint16_t compact[5];
+    CompressIndices(indices, 5, compact);
+    CHECK(compact[2] == 0xFFFE && compact[3] == 0xFFFF && compact[4] == 7);
+    CHECK(CanUse16BitIndices(0xFFFE) && !CanUse16BitIndices(0xFFFF));
+}
+
+// buddy allocator
+
+static void TestBuddyAllocator() {
+    BuddyAllocator allocator(1000, 64);
+    auto stats = allocator.GetStats();
+    CHECK(stats.capacity == 1024);
+    CHECK(stats.freeBlockCount == 1 && stats.largestFreeBlock == 1024);
+
+    // 100 -> 128 블록, 나머지는 128 / 256 / 512로 쪼개짐
+    size_t a = allocator.Allocate(100);
+    CHECK(a == 0);
+    CHECK(allocator.GetBlockSize(a) == 128);
+    stats = allocator.GetStats();
+    CHECK(stats.usedBytes == 128 && stats.requestedBytes == 100);
+    CHECK(stats.freeBlockCount == 3 && stats.largestFreeBlock == 512);
+    CHECK(std::fabs(stats.internalWaste - 28.0f / 128.0f) < 1e-6f);
+
+    // 정렬은 더 큰 블록으로
+    size_t b = allocator.Allocate(10, 256);
+    CHECK(b != BuddyAllocator::kInvalidOffset && b % 256 == 0);
+    CHECK(allocator.GetBlockSize(b) == 256);
+    CHECK(allocator.Allocate(2048) == BuddyAllocator::kInvalidOffset);
+
+    allocator.Free(a);
+    allocator.Free(b);
+    stats = allocator.GetStats();
+    CHECK(stats.allocationCount == 0 && stats.usedBytes == 0);
+    CHECK(stats.freeBlockCount == 1 && stats.largestFreeBlock == 1024);
+    CHECK(stats.fragmentation == 0.0f);
+
+    // 가득 채운 뒤 하나 걸러 해제하면 합쳐지지 않음
+    std::vector<size_t> blocks;
+    for (int i = 0; i < 16; i++)
+        blocks.push_back(allocator.Allocate(64));
+    const size_t invalid = BuddyAllocator::kInvalidOffset;
+    CHECK(std::find(blocks.begin(), blocks.end(), invalid) == blocks.end());
+    CHECK(allocator.Allocate(1) == BuddyAllocator::kInvalidOffset);
+    std::vector<size_t> sorted = blocks;
+    std::sort(sorted.begin(), sorted.end());
+    CHECK(std::unique(sorted.begin(), sorted.end()) == sorted.end());
+    for (int i = 0; i < 16; i += 2)
+        allocator.Free(blocks[i]);
+    stats = allocator.GetStats();
+    CHECK(stats.freeBlockCount == 8 && stats.largestFreeBlock == 64);
+    CHECK(std::fabs(stats.fragmentation - (1.0f - 64.0f / 512.0f)) < 1e-6f);
+    CHECK(allocator.Allocate(128) == BuddyAllocator::kInvalidOffset);
+    for (int i = 1; i < 16; i += 2)
+        allocator.Free(blocks[i]);
+    stats = allocator.GetStats();
+    CHECK(stats.freeBlockCount == 1 && stats.largestFreeBlock == 1024);
+
+    // 해제되지 않은 offset은 무시
+    allocator.Free(12345);
+    CHECK(allocator.GetStats().freeBytes == 1024);
+}
+
+// image kernels
+
+static void TestImageKernels() {
+    CHECK(GetMipLevelCount(1, 1) == 1);
+    CHECK(GetMipLevelCount(256, 256) == 9);
+    CHECK(GetMipLevelCount(1024, 3) == 11);
+
+    srand(1);
+    // SIMD 폭과 청크 경계를 지나는 개수들
+    for (size_t count : { 0, 1, 5, 6, 11, 12, 13, 100, 300001 }) {
+        std::vector<uint8_t> rgb(count * 3), rgba(count * 4);
+        for (auto& value : rgb)
+            value = (uint8_t)rand();
+        ExpandRGBToRGBA(rgb.data(), rgba.data(), count);
+        size_t bad = 0;
+        for (size_t i = 0; i < count; i++) {
+            for (int c = 0; c < 4; c++)
+                bad += rgba[i * 4 + c] != (c == 3 ? 255 : rgb[i * 3 + c]);
+        }
+        CHECK(bad == 0);
+    }
+
+    for (int width : { 1, 2, 3, 7, 33, 640 }) {
+        for (int height : { 1, 2, 5, 400 }) {
+            for (int channelCount : { 1, 2, 3, 4 }) {
+                size_t pitch = (size_t)width * channelCount;
+                std::vector<uint8_t> src(pitch * height);
+                for (auto& value : src)
+                    value = (uint8_t)rand();
+
+                auto flipped = src;
+                FlipVertical(flipped.data(), pitch, height);
+                for (int y = 0; y < height; y++)
+                    CHECK(memcmp(&flipped[pitch * y], &src[pitch * (height - 1 - y)], pitch) == 0);
+
+                int dstWidth = std::max(width / 2, 1), dstHeight = std::max(height / 2, 1);
+                std::vector<uint8_t> dst((size_t)dstWidth * dstHeight * channelCount);
+                DownsampleBox(src.data(), width, height, channelCount, dst.data());
+                size_t bad = 0;
+                for (int y = 0; y < dstHeight; y++) {
+                    for (int x = 0; x < dstWidth; x++) {
+                        int x0 = std::min(x * 2, width - 1), x1 = std::min(x * 2 + 1, width - 1);
+                        int y0 = std::min(y * 2, height - 1), y1 = std::min(y * 2 + 1, height - 1);
+                        for (int c = 0; c < channelCount; c++) {
+                            auto at = [&](int sx, int sy) { return src[pitch * sy + sx * channelCount + c]; };
+                            int sum = at(x0, y0) + at(x1, y0) + at(x0, y1) + at(x1, y1);
+                            bad += dst[((size_t)y * dstWidth + x) * channelCount + c] != (sum + 2) / 4;
+                        }
+                    }
+                }
+                CHECK(bad == 0);
+
+                // 필터와 무관하게 일정한 이미지는 그대로
+                std::vector<uint8_t> flat(src.size(), 77);
+                for (auto filter : { MipFilter::Box, MipFilter::Kaiser }) {
+                    for (bool srgb : { false, true }) {
+                        Downsample(flat.data(), width, height, channelCount, dst.data(), filter, srgb);
+                        CHECK(std::all_of(dst.begin(), dst.end(), [](uint8_t v) { return v == 77; }));
+                    }
+                }
+
+                // RGBA(SIMD 경로)는 채널을 하나씩 따로 줄인 결과와 같아야 함
+                if (channelCount != 4)
+                    continue;
+                std::vector<uint8_t> plane((size_t)width * height), planeDst((size_t)dstWidth * dstHeight);
+                for (auto filter : { MipFilter::Box, MipFilter::Kaiser }) {
+                    for (bool srgb : { false, true }) {
+                        Downsample(src.data(), width, height, 4, dst.data(), filter, srgb);
+                        int maxError = 0;
+                        for (int c = 0; c < 4; c++) {
+                            for (size_t i = 0; i < plane.size(); i++)
+                                plane[i] = src[i * 4 + c];
+                            Downsample(plane.data(), width, height, 1, planeDst.data(), filter, srgb && c < 3);
+                            for (size_t i = 0; i < planeDst.size(); i++)
+                                maxError = std::max(maxError, std::abs(dst[i * 4 + c] - planeDst[i]));
+                        }
+                        // FMA 축약 여부에 따른 반올림 차이만 허용
+                        CHECK(maxError <= 1);
+                    }
+                }
+            }
+        }
+    }
+
+    // 흑백 체크무늬의 평균: linear면 128, sRGB로 다시 인코딩하면 188
+    std::vector<uint8_t> checker(16 * 16 * 4);
+    for (int i = 0; i < 16 * 16; i++) {
+        uint8_t value = ((i % 16) + (i / 16)) % 2 ? 255 : 0;
+        checker[i * 4 + 0] = checker[i * 4 + 1] = checker[i * 4 + 2] = value;
+        checker[i * 4 + 3] = value;
+    }
+    std::vector<uint8_t> half(8 * 8 * 4);
+    Downsample(checker.data(), 16, 16, 4, half.data(), MipFilter::Box, true);
+    CHECK(half[0] == 188 && half[3] == 128);
+    Downsample(checker.data(), 16, 16, 4, half.data(), MipFilter::Box, false);
+    CHECK(half[0] == 128 && half[3] == 128);
+    Downsample(checker.data(), 16, 16, 4, half.data(), MipFilter::Kaiser, true);
+    CHECK(std::abs(half[(4 * 8 + 4) * 4] - 188) <= 1);
+}
+
+// texture container
+
+static void TestTextureContainer() {
+    auto directory = std::filesystem::temp_directory_path() / "primitives_tests";
+    std::filesystem::create_directories(directory);
+    std::string filename = (directory / "test.tex").string();
+
+    for (int channelCount : { 1, 3, 4 }) {
+        TextureContainerHeader header {};
+        header.internalFormat = channelCount == 1 ? kTextureFormatR8 : kTextureFormatRGBA8;
+        header.channelCount = channelCount;
+        header.width = 13;
+        header.height = 6;
+        header.rowAlignment = 4;
+        header.contentHash = TextureContainer::Hash(&channelCount, sizeof(channelCount));
+
+        std::vector<std::vector<uint8_t>> levels(GetMipLevelCount(13, 6));
+        for (size_t i = 0; i < levels.size(); i++) {
+            levels[i].resize((size_t)std::max(13 >> i, 1) * std::max(6 >> i, 1) * channelCount);
+            for (size_t k = 0; k < levels[i].size(); k++)
+                levels[i][k] = (uint8_t)(k * 7 + i);
+        }
+        CHECK(TextureContainer::Write(filename, header, levels));
+
+        auto container = TextureContainer::Open(filename, true);
+        CHECK(container != nullptr);
+        if (!container)
+            continue;
+        auto& read = container->GetHeader();
+        CHECK(read.width == 13 && read.height == 6 && read.channelCount == (uint32_t)channelCount);
+        CHECK(read.levelCount == levels.size());
+        CHECK(read.contentHash == header.contentHash);
+        for (size_t i = 0; i < levels.size(); i++) {
+            auto& level = container->GetLevel((int)i);
+            size_t rowBytes = (size_t)level.width * channelCount;
+            CHECK(level.rowPitch % 4 == 0 && level.rowPitch >= rowBytes);
+            CHECK(level.offset % kTextureContainerDataAlignment == 0);
+            for (uint32_t y = 0; y < level.height; y++)
+                CHECK(memcmp(container->GetLevelData((int)i) + level.rowPitch * y,
+                    levels[i].data() + rowBytes * y, rowBytes) == 0);
+        }
+    }
+
+    // 잘린 파일과 없는 파일은 열리지 않음
+    auto size = std::filesystem::file_size(filename);
+    std::filesystem::resize_file(filename, size - 1);
+    CHECK(TextureContainer::Open(filename) == nullptr);
+    std::filesystem::resize_file(filename, 8);
+    CHECK(TextureContainer::Open(filename) == nullptr);
+    CHECK(TextureContainer::Open((directory / "missing.tex").string()) == nullptr);
+    std::filesystem::remove_all(directory);
+
+    // 이어서 계산한 hash는 한 번에 계산한 것과 같음
+    const char text[] = "primitives";
+    CHECK(TextureContainer::Hash(text + 5, 5, TextureContainer::Hash(text, 5)) ==
+        TextureContainer::Hash(text, 10));
+}
+
+int main() {
+    struct { const char* name; std::function<void()> run; } tests[] = {
+        { "generators", TestGenerators },
+        { "sin/cos", TestSinCos },
+        { "mesh optimizer", TestMeshOptimizer },
+        { "vertex compression", TestVertexCompression },
+        { "buddy allocator", TestBuddyAllocator },
+        { "image kernels", TestImageKernels },
+        { "texture container", TestTextureContainer },
+    };
+    printf("ring simd path: %s, image simd path: %s\n", GetRingSimdPath(), GetImageKernelSimdPath());
+    for (auto& test : tests) {
+        int failures = g_failures;
+        test.run();
+        printf("%-20s %s\n", test.name, g_failures == failures ? "ok" : "FAILED");
+    }
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+// Offline texture cooking: decodes images once and writes texture
+// containers with the full mip chain, so the app only maps and uploads.
+// usage: texture_cooker [--box] [--linear] <output dir> <image>...
+// mips are Kaiser filtered in linear light by default and color images are
+// stored as GL_SRGB8_ALPHA8; --box uses the 2x2 average and --linear keeps
+// the data linear (normal maps, masks). 1 and 2 channel images have no sRGB
+// format and are always linear. RGB images are stored as RGBA. outputs are named
+// <output dir>/<image name without extension>.tex and only touched when
+// they already hold the same source and settings hash
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb/stb_image.h>
+#include "image_kernels.h"
+#include "texture_container.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+static const uint32_t kInternalFormats[] = {
+    kTextureFormatR8, kTextureFormatRG8, kTextureFormatRGB8, kTextureFormatRGBA8,
+};
+static const uint32_t kSrgbInternalFormats[] = {
+    kTextureFormatR8, kTextureFormatRG8, kTextureFormatSRGB8, kTextureFormatSRGB8Alpha8,
+};
+
+struct CookSettings {
+    MipFilter filter { MipFilter::Kaiser };
+    bool srgb { true };
+};
+
+static bool Cook(const std::filesystem::path& source, const std::filesystem::path& output,
+    const CookSettings& settings) {
+    std::ifstream fin(source, std::ios::binary);
+    if (!fin.is_open()) {
+        fprintf(stderr, "failed to open %s\n", source.string().c_str());
+        return false;
+    }
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+    uint64_t hash = TextureContainer::Hash(file.data(), file.size());
+    // 설정이 바뀌면 다시 굽도록 hash에 포함
+    const uint8_t settingBytes[] = { (uint8_t)settings.filter, (uint8_t)settings.srgb };
+    hash = TextureContainer::Hash(settingBytes, sizeof(settingBytes), hash);
+
+    auto existing = TextureContainer::Open(output.string());
+    if (existing && existing->GetHeader().contentHash == hash) {
+        existing.reset();
+        // 내용은 같아도 원본보다 새 파일이어야 빌드와 로더가 다시 cook 하지 않음
+        std::error_code error;
+        std::filesystem::last_write_time(output, std::filesystem::file_time_type::clock::now(), error);
+        printf("%-32s up to date\n", source.filename().string().c_str());
+        return true;
+    }
+
+    int width = 0, height = 0, channelCount = 0;
+    uint8_t* pixels = stbi_load_from_memory(file.data(), (int)file.size(),
+        &width, &height, &channelCount, 0);
+    if (!pixels) {
+        fprintf(stderr, "failed to decode %s: %s\n", source.string().c_str(), stbi_failure_reason());
+        return false;
+    }
+    // 런타임의 Image::Load와 같은 방향 (GL은 아래쪽 행부터), RGB는 RGBA로
+    FlipVertical(pixels, (size_t)width * channelCount, height);
+    int levelChannelCount = channelCount == 3 ? 4 : channelCount;
+    int levelCount = GetMipLevelCount(width, height);
+    std::vector<std::vector<uint8_t>> levels(levelCount);
+    levels[0].resize((size_t)width * height * levelChannelCount);
+    if (channelCount == 3)
+        ExpandRGBToRGBA(pixels, levels[0].data(), (size_t)width * height);
+    else
+        std::copy(pixels, pixels + levels[0].size(), levels[0].begin());
+    stbi_image_free(pixels);
+    channelCount = levelChannelCount;
+    // sRGB internal format가 있는 color 이미지만 linear light에서 filter
+    bool srgb = settings.srgb && channelCount >= 3;
+
+    TextureContainerHeader header {};
+    header.internalFormat = (srgb ? kSrgbInternalFormats : kInternalFormats)[channelCount - 1];
+    header.channelCount = channelCount;
+    header.width = width;
+    header.height = height;
+    header.rowAlignment = 4;
+    header.contentHash = hash;
+
+    for (int i = 1; i < levelCount; i++) {
+        int levelWidth = std::max(width >> i, 1);
+        int levelHeight = std::max(height >> i, 1);
+        levels[i].resize((size_t)levelWidth * levelHeight * channelCount);
+        Downsample(levels[i - 1].data(), std::max(width >> (i - 1), 1),
+            std::max(height >> (i - 1), 1), channelCount, levels[i].data(),
+            settings.filter, srgb);
+    }
+
+    if (!TextureContainer::Write(output.string(), header, levels)) {
+        fprintf(stderr, "failed to write %s\n", output.string().c_str());
+        return false;
+    }
+    printf("%-32s %dx%d, %d channels, %d levels -> %s\n", source.filename().string().c_str(),
+        width, height, channelCount, levelCount, output.string().c_str());
+    return true;
+}
+
+int main(int argc, const char** argv) {
+    CookSettings settings;
+    int first = 1;
+    for (; first < argc && argv[first][0] == '-'; first++) {
+        std::string option = argv[first];
+        if (option == "--box")
+            settings.filter = MipFilter::Box;
+        else if (option == "--linear")
+            settings.srgb = false;
+        else
+            break;
+    }
+    if (argc - first < 2) {
+        fprintf(stderr, "usage: texture_cooker [--box] [--linear] <output dir> <image>...\n");
+        return 1;
+    }
+    std::filesystem::path outputDir = argv[first];
+    std::error_code error;
+    std::filesystem::create_directories(outputDir, error);
+
+    auto start = std::chrono::steady_clock::now();
+    int failures = 0;
+    for (int i = first + 1; i < argc; i++) {
+        std::filesystem::path source = argv[i];
+        auto output = outputDir / source.stem();
+        output += ".tex";
+        if (!Cook(source, output, settings))
+            failures++;
+    }
+    auto end = std::chrono::steady_clock::now();
+    printf("cooked %d images in %.1f ms (%s)\n", argc - first - 1,
+        std::chrono::duration<double, std::milli>(end - start).count(), GetImageKernelSimdPath());
+    return failures == 0 ? 0 : 1;
+}